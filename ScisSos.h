@@ -1,6 +1,7 @@
 #ifndef SCISSOS_H
 #define SCISSOS_H
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,7 +9,7 @@
 /****
  *  Constants defining OS parameters
  ****/
-#define MAXPROC 1000  /* Max number of processes */
+#define MAXPROC 1000  /* Initial process table capacity; grows on demand */
 #define MAXUSRS 10    /* Max number of users */
 #define DEFPRIO 20    /* Default priority for process */
 #define EMPTY -100    /* Unfilled entries */
@@ -17,6 +18,36 @@
 #define REG_THR 0.02  /* Normal process: 2% long calls */
 #define CMP_THR 0.001 /* Compute Intensive: 0.1% */
 #define IOE_THR 0.2   /* IO Intensive: 20% long calls */
+#define ARENA_CHUNK (1 << 20) /* Bytes per instruction arena chunk */
+#define DEFIOLAT 2000 /* Default mean I/O latency of a long syscall (ticks) */
+#define CODE_CHUNK (1 << 14) /* Instructions per window of lazily generated code */
+#define MLFQ_LEVELS 4   /* Feedback queue levels; the quantum doubles at each level down */
+#define DEFBOOST 100000 /* Default ticks between MLFQ priority boosts */
+#define CFS_LATENCY 24000 /* Ticks in which every runnable process should run once */
+#define CFS_MIN_GRAN 3000 /* Shortest CFS time slice, stretches the period under load */
+#define CFS_SHIFT 10      /* Fixed-point bits of virtual runtime */
+#define NICE_0_WEIGHT 1024 /* CFS weight of a process at DEFPRIO */
+#define RT_MIN_PERIOD 10000    /* Shortest period of generated real-time processes (ticks) */
+#define RT_MAX_PERIOD 1000000  /* Longest period of generated real-time processes (ticks) */
+#define RT_BACKGROUND (1LL << 62) /* EDF/RM key of best-effort processes, behind every deadline */
+#define RT_RTA_MAX 4096        /* Most tasks put through exact rate-monotonic analysis */
+#define SHARE_SHIFT 24 /* Fixed-point bits of stride passes and the service-per-ticket clock */
+#define MAXCPUS 64              /* Most simulated CPUs; affinity masks have one bit per CPU */
+#define DEFBALANCE 20000        /* Default ticks between SMP load-balancing passes */
+#define STEAL_SCAN 32           /* Ready processes an idle CPU examines per victim when stealing */
+#define DEFSWITCH 16            /* Default preemptions per CPU in a window the adaptive quantum aims for */
+#define QUANTUM_WINDOW 20000    /* Ticks over which the adaptive quantum measures the switch rate */
+#define QUANTUM_ONE 1024        /* Fixed-point 1.0 of the adaptive quantum scale */
+#define QUANTUM_SCALE_MAX 16    /* The scale stays within [1/16, 16] */
+#define QUANTUM_FIT 2           /* The adaptive quantum fits this many predicted bursts */
+#define BURST_DECAY 2           /* Burst average keeps 3/4 of its history at each burst */
+
+/**** PID layout: low bits are table slot + 1, high bits a generation ***/
+#define PID_SLOT_BITS 24                             /* Up to 16M live processes */
+#define PID_SLOT_MASK ((1 << PID_SLOT_BITS) - 1)
+#define PID_GEN_MASK 0x7F                            /* Generation wraps after 128 reuses */
+#define PID_SLOT(pid) (((pid) & PID_SLOT_MASK) - 1)  /* Table slot of a PID */
+#define PCB_OF(ctx, pid) ((ctx)->proctable[PID_SLOT(pid)]) /* PCB of a live PID, unchecked */
 
 /**** Constants for Process States ************************************/
 #define PS_NEW 0
@@ -37,7 +68,39 @@
 #define INS_LNG 10 /* Long instruction */
 #define INS_SHR 20 /* Short instruction */
 
+/**** I/O latency distributions for long syscalls **********************/
+#define LAT_NONE 0    /* Completes at the next scheduler call */
+#define LAT_FIXED 1   /* Always the mean */
+#define LAT_UNIFORM 2 /* Uniform in [0, 2 * mean) */
+#define LAT_EXP 3     /* Exponential with the given mean */
+
+/**** Log levels; each level includes the ones before it ***************/
+#define LOG_OFF 0       /* No output */
+#define LOG_SUMMARY 1   /* Start-up banners and final statistics */
+#define LOG_DECISIONS 2 /* Process creation, scheduling decisions, blocks, unblocks */
+#define LOG_TRACE 3     /* Scheduler invocations, ready queue dumps, PC updates */
+
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL LOG_TRACE /* Levels above this are compiled out */
+#endif
+#define LOG_BUFSIZE (1 << 20)   /* Bytes of stdout buffering for log output */
+
+/* True when output at this level is both compiled in and enabled for the context */
+#define SCISSOS_LOG_ON(ctx, level) ((level) <= LOG_MAX_LEVEL && (level) <= (ctx)->log_level)
+
+/* Log to the context's stream at the given level; arguments are not evaluated when off */
+#define SCISSOS_LOG(ctx, level, ...)               \
+    do                                             \
+    {                                              \
+        if (SCISSOS_LOG_ON(ctx, level))            \
+        {                                          \
+            fprintf((ctx)->log_out, __VA_ARGS__);  \
+        }                                          \
+    } while (0)
+
 typedef int ScisSosPGTable[2];
+typedef unsigned long long ScisSosTime; /* Simulated clock ticks */
+#define NO_TIME ((ScisSosTime)-1)       /* Time not reached yet */
 
 /** Instruction in a process; process is a sequence of instructions **/
 typedef struct
@@ -47,10 +110,60 @@ typedef struct
     int _addref;  /* Memory address reference */
 } ScisSosInst;
 
+/** xoshiro256** generator state; one per context and one per process **/
+typedef struct
+{
+    unsigned long long s[4];
+} ScisSosRng;
+
+/** Packed instruction stream: long-syscall bitmap, skip index and addresses. The arrays
+ *  hold instructions [base, limit); lazy streams hold one CODE_CHUNK window at a time and
+ *  regenerate the arrays in place from rng as the program counter moves on. **/
+typedef struct
+{
+    int size;                     /* Number of instructions */
+    int base;                     /* First instruction held in the arrays */
+    int limit;                    /* One past the last instruction held */
+    int lazy;                     /* Generated one window at a time */
+    unsigned long long long_thr;  /* Long syscall if the high half of a draw is below this */
+    ScisSosRng rng;               /* Generator state for the instructions from limit on */
+    unsigned long long *lng;      /* Bit i set if instruction base + i is a long syscall */
+    int *skip;                    /* skip[w]: first long syscall in word w or later, limit if none */
+    unsigned short *addref;       /* Memory address reference per instruction */
+} ScisSosCode;
+
+#define CODE_WORDS(size) (((size) + 63) / 64) /* Bitmap words for size instructions */
+
+/** Red-black tree node embedded in its owner; ordered by key, ties broken by ID **/
+typedef struct ScisSosRbNode
+{
+    struct ScisSosRbNode *parent; /* NULL at the root */
+    struct ScisSosRbNode *left;   /* Smaller keys */
+    struct ScisSosRbNode *right;  /* Larger keys */
+    long long key;                /* Ordering key */
+    int id;                       /* Owner: PID of a process, uid of a user */
+    int red;                      /* Colour */
+} ScisSosRbNode;
+
+/** Red-black tree of processes with its leftmost node cached **/
+typedef struct
+{
+    ScisSosRbNode *root;     /* NULL if empty */
+    ScisSosRbNode *leftmost; /* Smallest node, NULL if empty */
+    int count;               /* Number of nodes */
+} ScisSosRbTree;
+
+/** Fair-share state of one user on one CPU; its usage is kept in the context **/
+typedef struct
+{
+    ScisSosRbTree ready; /* User's ready processes, ordered by the inner policy */
+    ScisSosRbNode node;  /* Entry in the user tree while the user has ready processes */
+} ScisSosUser;
+
 /** Process Control Block structure **/
 typedef struct
 {
-    int pid;                          /* Process ID 1 to MAXPROC */
+    int pid;                          /* Process ID (slot + generation) */
     int uid;                          /* User ID 1 to MAXUSRS */
     int size;                         /* Size specified by users */
     int priority_value;               /* Priority value */
@@ -58,11 +171,91 @@ typedef struct
     int p_type;                       /* Process Type (See above) */
     int m_type;                       /* Memory behaviour */
     int pc;                           /* Program Counter */
-    ScisSosInst **p_code;             /* Pointer to exectable code */
+    ScisSosCode *p_code;              /* Pointer to exectable code */
     ScisSosPGTable pg_table[MAXPGES]; /* Page Table Information */
     int p_timeslice;                  /* Current Time-Slice */
+    int q_next;                       /* Next PID in ready/block queue */
+    int q_prev;                       /* Previous PID in ready/block queue */
+    int heap_pos;                     /* Slot in scheduler heap, EMPTY if none */
+    int level;                        /* MLFQ level, 0 is the top */
+    unsigned int level_epoch;         /* MLFQ boost the level belongs to */
+    int l_next;                       /* Next PID in MLFQ level queue */
+    int l_prev;                       /* Previous PID in MLFQ level queue */
+    long long vruntime;               /* CFS virtual runtime, ticks << CFS_SHIFT at NICE_0_WEIGHT */
+    int weight;                       /* CFS weight while in the run queue */
+    ScisSosRbNode rb;                 /* CFS or fair-share run queue node */
+    int period;                       /* Real-time release period in ticks, 0 if best effort */
+    int rel_deadline;                 /* Real-time deadline relative to each release */
+    int wcet;                         /* Real-time instructions per job (worst-case execution time) */
+    int job_done;                     /* Instructions the current job has executed */
+    ScisSosTime t_release;            /* Release time of the current job */
+    ScisSosTime t_deadline;           /* Absolute deadline of the current job */
+    int tickets;                      /* Proportional-share tickets, from priority_value */
+    long long lottery_tickets;        /* Tickets drawn on, inflated after a partly used quantum */
+    long long pass;                   /* Stride pass, ticks << SHARE_SHIFT per ticket */
+    long long share_mark;             /* share_pass when the entitlement was last settled */
+    double entitled;                  /* CPU ticks its tickets entitled it to while runnable */
+    int cpu;                          /* CPU whose run queue holds it, or it runs on */
+    int last_cpu;                     /* CPU it last ran on, EMPTY if it never ran */
+    int vr_cpu;                       /* CPU whose min_vruntime its vruntime is relative to */
+    unsigned long long affinity;      /* Bit c set if it may run on CPU c */
+    int burst_avg;                    /* Exponential average of its CPU bursts between long syscalls */
+    int burst_run;                    /* Ticks of the CPU burst in progress */
+    int quanta;                       /* Dispatches */
+    int preemptions;                  /* Quanta that ended with it still ready */
+    ScisSosTime t_arrival;            /* Time the process was created */
+    ScisSosTime t_first_run;          /* Time of first dispatch, NO_TIME if never run */
+    ScisSosTime t_completion;         /* Time it finished, NO_TIME if not finished */
+    ScisSosTime t_ready;              /* Total time spent READY */
+    ScisSosTime t_blocked;            /* Total time spent BLOCKED */
+    ScisSosTime t_last;               /* Time of the last state change */
 } ScisSosPCB;
 
+/** Scheduling quality figures of a completed process **/
+typedef struct
+{
+    int pid;                  /* Process ID */
+    int uid;                  /* User ID */
+    int p_type;               /* Process Type */
+    int priority_value;       /* Priority value */
+    int size;                 /* Instructions executed */
+    ScisSosTime arrival;      /* Creation time */
+    ScisSosTime first_run;    /* First dispatch time */
+    ScisSosTime completion;   /* Completion time */
+    ScisSosTime ready;        /* Time spent waiting in the ready queue */
+    ScisSosTime blocked;      /* Time spent blocked */
+    double entitled;          /* CPU ticks its tickets entitled it to */
+    int quanta;               /* Dispatches */
+    int preemptions;          /* Quanta that ended with it still ready */
+} ScisSosProcStats;
+
+/** Aggregate scheduling figures of one run **/
+typedef struct
+{
+    int completed;         /* Completed processes */
+    double turnaround;     /* Mean turnaround time */
+    double waiting;        /* Mean time spent ready */
+    double response;       /* Mean time to first dispatch */
+    ScisSosTime makespan;  /* First arrival to last completion */
+    double utilisation;    /* Busy share of the makespan, percent */
+    double throughput;     /* Completions per 1000 ticks */
+    int jobs;              /* Completed real-time jobs */
+    int misses;            /* Jobs that completed after their deadline */
+    double lateness;       /* Mean completion minus deadline of the jobs */
+    double share_error;    /* CPU used by others than the processes entitled to it, percent */
+    long migrations;       /* Dispatches on another CPU than the process last ran on */
+    long preemptions;      /* Quanta that ended with the process still ready */
+    double latency;        /* Mean time spent ready per dispatch */
+} ScisSosRunSummary;
+
+/** Intrusive queue of PCBs, linked through q_next/q_prev **/
+typedef struct
+{
+    int head;  /* First PID in queue, EMPTY if none */
+    int tail;  /* Last PID in queue, EMPTY if none */
+    int count; /* Number of queued processes */
+} ScisSosQueue;
+
 /** Process Structure **/
 typedef struct
 {
@@ -70,28 +263,290 @@ typedef struct
     int _PID;            /* PID */
     int _psize;          /* Size of the process */
     ScisSosPCB *_pcb;    /* Pointer to its PCB */
-    ScisSosInst **_CODE; /* Pointer to its code */
+    ScisSosCode *_CODE;  /* Pointer to its code */
 } ScisSosProcess;
 
-/** Data structures used by the OS to do its management actions **/
-extern ScisSosPCB *_proctable[MAXPROC]; /* Process Table */
-extern int _readyQ[MAXPROC];            /* Ready Queue */
-extern int _blockQ[MAXPROC];            /* Wait Queue */
-extern int _currentPID;                 /* Current running process PID */
+/** Synthetic workload: process count, size, type mix and priority range **/
+typedef struct
+{
+    int count;          /* Number of processes */
+    int mean_size;      /* Sizes uniform in [mean_size / 2, 3 * mean_size / 2] */
+    int type_weight[3]; /* Relative share of PT_REG, PT_CMP and PT_IOE */
+    int max_priority;   /* Priorities uniform in [1, max_priority] */
+    int threads;        /* Threads building PCBs and code; 0 or 1 builds serially */
+    int rt_tasks;       /* Processes made periodic, implicit deadlines */
+    double rt_util;     /* Total utilisation shared among them */
+} ScisSosWorkloadSpec;
+
+/** Indexed min-heap node; the PCB records its slot in heap_pos **/
+typedef struct
+{
+    long long key;   /* Ordering key (smallest first) */
+    int pid;         /* PID, breaks ties between equal keys */
+    ScisSosPCB *pcb; /* Process in this slot */
+} ScisSosHeapNode;
+
+/** Indexed min-heap of processes **/
+typedef struct
+{
+    ScisSosHeapNode *nodes; /* Heap-ordered array of nodes */
+    int size;               /* Number of nodes in use */
+    int capacity;           /* Number of nodes allocated */
+} ScisSosHeap;
+
+/** Fenwick (binary indexed) tree of non-negative counts over table slots **/
+typedef struct
+{
+    long long *sums; /* sums[i] covers values (i - lowbit(i), i], 1-based */
+    int size;        /* Values covered, a power of two */
+    long long total; /* Sum of all values */
+} ScisSosFenwick;
+
+/** Ready processes of one simulated CPU, in the structure of every policy. Fair-share usage
+ *  is global, so users get their share across all CPUs; lottery tickets are drawn only
+ *  against the other processes on the same CPU, so lottery shares hold per CPU and the
+ *  load balancer, which evens out queue lengths, not tickets, decides the rest **/
+typedef struct
+{
+    ScisSosQueue readyQ;            /* Ready Queue */
+    ScisSosHeap ready_heap;         /* Ready processes ordered by policy key */
+    ScisSosQueue mlfq[MLFQ_LEVELS]; /* Ready processes per MLFQ level, linked through l_next/l_prev */
+    unsigned int mlfq_mask;         /* Bit l set while level l is non-empty */
+    ScisSosRbTree cfs_tree;         /* Ready processes ordered by vruntime */
+    long long cfs_weight;           /* Total weight of cfs_tree */
+    long long min_vruntime;         /* Never decreasing floor of ready vruntimes */
+    ScisSosUser users[MAXUSRS + 1]; /* Fair-share state, indexed by uid */
+    ScisSosRbTree user_tree;        /* Users with ready processes ordered by usage */
+    long long fshare_seq;           /* Arrival order within a user */
+    ScisSosFenwick lottery;         /* Tickets of ready processes by table slot */
+} ScisSosRunQueue;
+
+/** One simulated CPU **/
+typedef struct
+{
+    ScisSosRunQueue rq;         /* Processes waiting for this CPU */
+    int current_pid;            /* Process running, EMPTY if none */
+    int burst_state;            /* State the running quantum ends in */
+    int burst_ticks;            /* Instructions in the running quantum */
+    ScisSosTime free_at;        /* Clock at which the running quantum ends */
+    ScisSosTime busy_ticks;     /* Instructions executed */
+    ScisSosTime overhead_ticks; /* Migration cost paid */
+    ScisSosTime idle_ticks;     /* Time with nothing to run */
+    ScisSosTime idle_since;     /* Clock at which it last went idle */
+    long dispatches;            /* Quanta started */
+    long migrations;            /* Quanta of a process that last ran on another CPU */
+    long steals;                /* Processes pulled from another queue while idle */
+    long balanced;              /* Processes moved here by load balancing */
+} ScisSosCpu;
+
+struct ScisSosPolicy;      /* scheduling_algo.h */
+struct ScisSosEvent;       /* event.c */
+struct ScisSosQuantum;     /* quantum.c */
+struct ScisSosChunk;       /* arena.c */
+struct ScisSosTraceHeader; /* trace.h */
+struct ScisSosTraceRecord; /* trace.h */
+
+/** Complete state of one simulation; independent contexts may run on separate threads **/
+typedef struct
+{
+    /* Process table */
+    ScisSosPCB **proctable;      /* Process Table, indexed by PID_SLOT */
+    int proc_capacity;           /* Slots in the process table */
+    int proc_count;              /* Processes in the process table */
+    unsigned char *slot_gen;     /* Generation of each table slot */
+    int *free_slots;             /* Stack of released slots */
+    int free_count;              /* Entries in free_slots */
+    int slot_high;               /* Slots handed out at least once */
+
+    /* Scheduling */
+    ScisSosCpu *cpus;                   /* Simulated CPUs */
+    int ncpu;                           /* Number of CPUs */
+    ScisSosRunQueue *rq;                /* Run queue of the CPU being scheduled */
+    ScisSosQueue blockQ;                /* Wait Queue */
+    int active_count;                   /* Processes not NEW or DEAD */
+    int ready_count;                    /* Processes READY, on any CPU */
+    int reap_dead;                      /* Delete processes when they complete */
+    int timeslice;                      /* Time slice given to new processes */
+    int lazy_code;                      /* Generate large code streams one window at a time */
+    const struct ScisSosPolicy *policy; /* Active scheduling policy */
+
+    /* SMP */
+    ScisSosTime migration_cost;   /* Ticks a CPU spends warming up for a process that ran elsewhere */
+    ScisSosTime balance_period;   /* Ticks between load-balancing passes */
+    ScisSosTime next_balance;     /* Clock of the next pass */
+    int affinity_width;           /* CPUs a new process may use, 0 for all */
+    unsigned long long idle_cpus; /* Bit c set while CPU c runs nothing */
+    int busy_heap[MAXCPUS];       /* Running CPUs, min-heap on (free_at, CPU) */
+    int busy_count;               /* Entries in busy_heap */
+
+    /* Time-slice controller */
+    const struct ScisSosQuantum *quantum; /* Sizes each process's next quantum */
+    int switch_target;              /* Preemptions per CPU in a window the adaptive controller aims for */
+    int quantum_scale;              /* Adaptive slice multiplier, QUANTUM_ONE is 1.0 */
+    ScisSosTime window_start;       /* Clock the switch-rate window opened at */
+    long window_preemptions;        /* Preemptions in the window */
+
+    /* Multi-level feedback queue */
+    unsigned int mlfq_epoch;        /* Boosts so far; older levels count as the top */
+    ScisSosTime boost_period;       /* Ticks between boosts */
+    ScisSosTime next_boost;         /* Clock of the next boost */
+
+    /* Fair share */
+    long long user_usage[MAXUSRS + 1]; /* CPU ticks each user consumed, on any CPU */
+    long long min_usage;               /* Never decreasing floor of scheduled users' usage */
+
+    /* Proportional share */
+    ScisSosRng lottery_rng;         /* Lottery draws, apart from the context stream */
+    long long share_tickets;        /* Tickets of ready and running processes */
+    long long share_pass;           /* CPU ticks << SHARE_SHIFT handed out per ticket */
+
+    /* Real-time admission */
+    int rt_count;                   /* Admitted periodic processes */
+    double rt_util;                 /* Sum of wcet / period */
+    double rt_density;              /* Sum of wcet / deadline, kept at most 1 */
+
+    /* Simulated time and pending I/O completions */
+    ScisSosTime clock;           /* Simulated time, one tick per instruction */
+    ScisSosTime idle_ticks;      /* Simulated time with no process running */
+    struct ScisSosEvent *events; /* Min-heap ordered by (time, seq) */
+    int event_count;
+    int event_capacity;
+    unsigned long long event_seq;
+    int io_dist;                 /* Latency distribution (LAT_*) */
+    double io_mean;              /* Mean latency in ticks */
+
+    /* Instruction arena */
+    struct ScisSosChunk *arena_chunks;  /* All chunks, newest first */
+    struct ScisSosChunk *arena_current; /* Chunk small allocations come from */
+
+    /* Workload file mapping; loaded processes' code points into it */
+    void *workload_map;
+    size_t workload_bytes;
+
+    /* Completed processes in completion order */
+    ScisSosProcStats *completed;
+    int completed_count;
+    int completed_capacity;
+
+    /* Completed real-time jobs */
+    long long *lateness;         /* Completion minus deadline, negative if early */
+    int job_count;
+    int job_capacity;
+    int deadline_misses;
+
+    /* State-transition trace */
+    struct ScisSosTraceHeader *trace_hdr;  /* Mapped header, NULL when tracing is off */
+    struct ScisSosTraceRecord *trace_ring; /* Ring of records after the header */
+    unsigned int trace_mask;               /* capacity - 1 */
+    size_t trace_bytes;                    /* Size of the mapping */
+
+    /* Output and randomness */
+    int log_level;               /* Runtime log level (LOG_*) */
+    FILE *log_out;               /* Log stream, stdout by default */
+    unsigned long long seed;     /* Master seed; process streams derive from it and their PID */
+    ScisSosRng rng;              /* Context stream: workloads and I/O latencies */
+} ScisSosContext;
 
 /** Process-related functions found in process.c file **/
-ScisSosProcess *scissos_proc_create(char *process_name, int size, int priority, int p_type); /* Create a new process */
+ScisSosProcess *scissos_proc_create(ScisSosContext *ctx, char *process_name, int size, int priority, int p_type); /* Create a new process */
 int scissos_proc_save(ScisSosProcess *process, FILE *process_info);                          /* Save process info to file */
 void scissos_print_pcb(ScisSosProcess *process, FILE *pcb_info);                             /* Print PCB info */
-int scissos_proc_run(int pid, char *scheduler);                                              /* Run the process with given PID */
-void scissos_proc_delete(int pid);                                                           /* Delete the process with given PID */
+void scissos_pcb_init(ScisSosContext *ctx, ScisSosPCB *pcb, int pid, int uid, int size,
+                      int priority, int p_type, ScisSosCode *code);                          /* Initialise a PCB */
+int scissos_proc_register(ScisSosContext *ctx, ScisSosPCB *pcb);                             /* Enter PCB in table, make ready */
+int scissos_proc_run(ScisSosContext *ctx, int pid);                                          /* Run the process with given PID */
+void scissos_proc_delete(ScisSosContext *ctx, int pid);                                      /* Delete the process with given PID */
+int scissos_proc_set_priority(ScisSosContext *ctx, int pid, int priority);                   /* Change priority of a process */
+int scissos_proc_set_realtime(ScisSosContext *ctx, int pid, int period, int deadline, int wcet); /* Admit as periodic */
+int scissos_proc_set_affinity(ScisSosContext *ctx, int pid, unsigned long long mask);        /* CPUs it may run on */
+int scissos_proc_start(ScisSosContext *ctx, ScisSosPCB *pcb);                                /* Plan one quantum */
+int scissos_proc_finish(ScisSosContext *ctx, ScisSosPCB *pcb, int exec_instr, int new_state); /* End a quantum */
+ScisSosCode *scissos_code_alloc(ScisSosContext *ctx, int size);                              /* Allocate packed code stream */
+void scissos_code_fill(ScisSosCode *code, ScisSosRng *rng, int p_type);                     /* Generate instructions and index */
+void scissos_code_index(ScisSosCode *code);                                                  /* Build the skip index */
+int scissos_code_next_long(const ScisSosCode *code, int pc);                                 /* Next long syscall in the window */
+void scissos_code_seek(ScisSosCode *code, int pc);                                           /* Bring pc into the window */
+int scissos_code_scan_long(ScisSosCode *code, int pc, int end);                              /* First long syscall in [pc, end) */
+void scissos_code_fetch(const ScisSosCode *code, int i, ScisSosInst *inst);                  /* Decode one instruction */
 
 /** OS-related functions found in os.c file **/
-void scissos_initialise(void);                /* Initialise the OS */
-void scissos_call_scheduler(char *scheduler); /* Call the scheduler */
-void scisos_update_queues(void);              /* Update the ready and block queues */
-int scissos_count_ready_processes(void);      /* Count ready processes */
-void scissos_unblock_process(void);           /* Unblock processes */
-int scisos_active_processes(void);            /* Check for active processes */
-
-#endif
\ No newline at end of file
+ScisSosContext *scissos_context_create(void);          /* Allocate a simulation with default settings */
+void scissos_context_destroy(ScisSosContext *ctx);     /* Shut down and free a simulation */
+void scissos_initialise(ScisSosContext *ctx);          /* Initialise the OS */
+void scissos_log_init(void);                           /* Buffer stdout for log output; call once at start-up */
+void scissos_set_log_level(ScisSosContext *ctx, int level); /* Set runtime log level */
+int scissos_parse_log_level(const char *name);         /* Log level from its name, -1 if unknown */
+void scissos_seed(ScisSosContext *ctx, unsigned long long seed); /* Set the master seed */
+int scissos_set_scheduler(ScisSosContext *ctx, const char *scheduler); /* Select scheduling policy by name */
+int scissos_call_scheduler(ScisSosContext *ctx);       /* Dispatch one process on CPU 0; returns its PID or EMPTY */
+long scissos_run_dispatcher(ScisSosContext *ctx);      /* Dispatch until no active processes remain; -1 on failure */
+void scissos_shutdown(ScisSosContext *ctx);            /* Delete all processes and release the arena */
+int scissos_pid_alloc(ScisSosContext *ctx);            /* Reserve a table slot; returns its PID or EMPTY */
+void scissos_pid_release(ScisSosContext *ctx, int pid); /* Free a PID's slot for reuse */
+ScisSosPCB *scissos_pcb_lookup(ScisSosContext *ctx, int pid); /* PCB of a PID, NULL if invalid or stale */
+void scissos_set_reap(ScisSosContext *ctx, int reap);  /* Delete processes as soon as they complete */
+int scissos_set_timeslice(ScisSosContext *ctx, int timeslice);       /* Time slice of processes created from now on */
+void scissos_set_lazy_code(ScisSosContext *ctx, int lazy);           /* Generate code of new processes as it runs */
+int scissos_set_boost_period(ScisSosContext *ctx, long long period); /* Ticks between MLFQ boosts */
+int scissos_set_cpus(ScisSosContext *ctx, int ncpu);                 /* Number of simulated CPUs, before any process exists */
+int scissos_set_migration_cost(ScisSosContext *ctx, long long cost); /* Ticks lost running a process that ran on another CPU */
+int scissos_set_balance_period(ScisSosContext *ctx, long long period); /* Ticks between SMP load-balancing passes */
+int scissos_set_affinity_width(ScisSosContext *ctx, int width);      /* CPUs each new process may use, 0 for all */
+int scissos_count_ready_processes(ScisSosContext *ctx); /* Count ready processes */
+int scissos_unblock_process(ScisSosContext *ctx);      /* Unblock processes */
+int scisos_active_processes(ScisSosContext *ctx);      /* Check for active processes */
+int scissos_set_state(ScisSosContext *ctx, ScisSosPCB *pcb, int state); /* State transition; keeps queues in sync */
+void scissos_ready_update(ScisSosContext *ctx, ScisSosPCB *pcb); /* Ready process changed its scheduling key */
+unsigned long long scissos_allowed_cpus(ScisSosContext *ctx, const ScisSosPCB *pcb); /* Simulated CPUs it may use */
+int scissos_select_cpu(ScisSosContext *ctx, ScisSosPCB *pcb);                        /* CPU to queue it on */
+int scissos_migrate(ScisSosContext *ctx, ScisSosPCB *pcb, int cpu);                  /* Move a ready process */
+void scissos_set_tickets(ScisSosContext *ctx, ScisSosPCB *pcb, int tickets); /* Change proportional-share tickets */
+
+/** Queue operations found in os.c file, all O(1) **/
+void scissos_queue_init(ScisSosQueue *q);                                              /* Empty the queue */
+void scissos_queue_push(ScisSosContext *ctx, ScisSosQueue *q, ScisSosPCB *pcb);        /* Append at the tail */
+void scissos_queue_push_front(ScisSosContext *ctx, ScisSosQueue *q, ScisSosPCB *pcb);  /* Insert at the head */
+void scissos_queue_remove(ScisSosContext *ctx, ScisSosQueue *q, ScisSosPCB *pcb);      /* Unlink from anywhere */
+
+/** Instruction arena found in arena.c file **/
+void *scissos_arena_alloc(ScisSosContext *ctx, size_t bytes); /* Allocate contiguous block */
+void scissos_arena_release(ScisSosContext *ctx, void *ptr);   /* Release block; chunk freed when empty */
+void scissos_arena_destroy(ScisSosContext *ctx);              /* Free the whole arena */
+
+/** Scheduling metrics found in metrics.c file **/
+void scissos_metrics_reset(ScisSosContext *ctx);                   /* Forget all completed processes */
+void scissos_metrics_record(ScisSosContext *ctx, const ScisSosPCB *pcb); /* Record a process that just completed */
+int scissos_metrics_count(ScisSosContext *ctx);                    /* Number of completed processes recorded */
+void scissos_metrics_report(ScisSosContext *ctx, FILE *out, const char *scheduler, int per_process); /* Print metrics */
+int scissos_metrics_export_csv(ScisSosContext *ctx, FILE *out);    /* Write per-process metrics as CSV */
+void scissos_metrics_summary(ScisSosContext *ctx, ScisSosRunSummary *sum); /* Means, makespan, utilisation, throughput */
+void scissos_metrics_record_job(ScisSosContext *ctx, const ScisSosPCB *pcb); /* Record a real-time job that just completed */
+double scissos_percentile(const double *sorted, int n, double p);  /* Nearest-rank percentile */
+
+/** Discrete-event queue of I/O completions found in event.c file **/
+void scissos_event_reset(ScisSosContext *ctx);                          /* Drop all pending events */
+int scissos_set_io_latency(ScisSosContext *ctx, int dist, double mean); /* Select latency distribution */
+int scissos_parse_io_latency(ScisSosContext *ctx, const char *spec);    /* Apply "none", "fixed:N", "uniform:N" or "exp:N" */
+int scissos_event_schedule_io(ScisSosContext *ctx, const ScisSosPCB *pcb); /* Schedule I/O completion of blocked process */
+int scissos_event_schedule_at(ScisSosContext *ctx, const ScisSosPCB *pcb, ScisSosTime time); /* Wake a process at a time */
+ScisSosTime scissos_event_next_time(ScisSosContext *ctx);               /* Earliest event time, NO_TIME if none */
+int scissos_event_pop_due(ScisSosContext *ctx);                         /* PID of an event due by now, EMPTY if none */
+
+/** Time-slice controllers found in quantum.c file **/
+int scissos_set_quantum(ScisSosContext *ctx, const char *name, int target); /* Select controller and switch-rate target */
+int scissos_parse_quantum(ScisSosContext *ctx, const char *spec);          /* Apply "fixed", "adaptive" or "adaptive:N" */
+void scissos_quantum_reset(ScisSosContext *ctx);                           /* Unscaled slices, fresh switch-rate window */
+void scissos_quantum_update(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks, int state); /* Quantum ended; size the next */
+
+/** Synthetic workloads found in workload.c file **/
+int scissos_parse_mix(const char *spec, int type_weight[3]);                   /* Parse "R/C/I" type weights */
+int scissos_parse_rt(const char *spec, int *tasks, double *util);             /* Parse "tasks:util" real-time load */
+int scissos_workload_create(ScisSosContext *ctx, const ScisSosWorkloadSpec *spec); /* Create processes; returns count or -1 */
+
+/** Seeded random numbers found in rng.c file **/
+void scissos_rng_seed(ScisSosRng *rng, unsigned long long seed, unsigned long long stream); /* Seed one stream */
+unsigned long long scissos_rng_next(ScisSosRng *rng);                                    /* Next 64 random bits */
+double scissos_rng_double(ScisSosRng *rng);                                              /* Uniform in [0, 1) */
+int scissos_rng_below(ScisSosRng *rng, int n);                                           /* Uniform in [0, n) */
+
+#endif
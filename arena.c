@@ -0,0 +1,137 @@
+#include "ScisSos.h"
+
+/** A chunk of arena memory; allocations are carved from data[] **/
+typedef struct ScisSosChunk
+{
+    struct ScisSosChunk *next; /* Next chunk in the arena */
+    struct ScisSosChunk *prev; /* Previous chunk in the arena */
+    size_t size;               /* Bytes available in data[] */
+    size_t used;               /* Bytes handed out so far */
+    int live;                  /* Allocations not yet released */
+    max_align_t data[];        /* Allocation space */
+} ScisSosChunk;
+
+/** Header placed in front of each allocation to find its chunk **/
+typedef union
+{
+    ScisSosChunk *chunk;
+    max_align_t align;
+} ScisSosArenaHdr;
+
+// Round up to the allocation alignment
+static size_t scissos_arena_align(size_t bytes)
+{
+    size_t a = sizeof(max_align_t);
+    return (bytes + a - 1) / a * a;
+}
+
+// Allocate a new chunk and link it into the arena
+static ScisSosChunk *scissos_arena_new_chunk(ScisSosContext *ctx, size_t size)
+{
+    ScisSosChunk *chunk = (ScisSosChunk *)malloc(sizeof(ScisSosChunk) + size);
+    if (!chunk)
+    {
+        return NULL;
+    }
+
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->live = 0;
+    chunk->prev = NULL;
+    chunk->next = ctx->arena_chunks;
+    if (ctx->arena_chunks)
+    {
+        ctx->arena_chunks->prev = chunk;
+    }
+    ctx->arena_chunks = chunk;
+
+    return chunk;
+}
+
+// Unlink a chunk from the arena and free it
+static void scissos_arena_free_chunk(ScisSosContext *ctx, ScisSosChunk *chunk)
+{
+    if (chunk->prev)
+    {
+        chunk->prev->next = chunk->next;
+    }
+    else
+    {
+        ctx->arena_chunks = chunk->next;
+    }
+    if (chunk->next)
+    {
+        chunk->next->prev = chunk->prev;
+    }
+    if (chunk == ctx->arena_current)
+    {
+        ctx->arena_current = NULL;
+    }
+    free(chunk);
+}
+
+// Allocate a contiguous block from the arena
+void *scissos_arena_alloc(ScisSosContext *ctx, size_t bytes)
+{
+    size_t need = sizeof(ScisSosArenaHdr) + scissos_arena_align(bytes);
+    ScisSosChunk *chunk = ctx->arena_current;
+
+    // Large blocks get a chunk of their own so they can be returned promptly
+    if (need > ARENA_CHUNK / 4)
+    {
+        chunk = scissos_arena_new_chunk(ctx, need);
+    }
+    else if (chunk == NULL || chunk->size - chunk->used < need)
+    {
+        chunk = scissos_arena_new_chunk(ctx, ARENA_CHUNK);
+        ctx->arena_current = chunk;
+    }
+
+    if (!chunk)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for arena chunk.\n");
+        return NULL;
+    }
+
+    ScisSosArenaHdr *hdr = (ScisSosArenaHdr *)((char *)chunk->data + chunk->used);
+    hdr->chunk = chunk;
+    chunk->used += need;
+    chunk->live++;
+
+    return hdr + 1;
+}
+
+// Release a block; its chunk is freed (or recycled) once nothing in it is live
+void scissos_arena_release(ScisSosContext *ctx, void *ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    ScisSosChunk *chunk = ((ScisSosArenaHdr *)ptr - 1)->chunk;
+
+    if (--chunk->live > 0)
+    {
+        return;
+    }
+
+    if (chunk == ctx->arena_current)
+    {
+        chunk->used = 0;
+    }
+    else
+    {
+        scissos_arena_free_chunk(ctx, chunk);
+    }
+}
+
+// Free every chunk in the arena at the end of a run
+void scissos_arena_destroy(ScisSosContext *ctx)
+{
+    while (ctx->arena_chunks)
+    {
+        scissos_arena_free_chunk(ctx, ctx->arena_chunks);
+    }
+    ctx->arena_current = NULL;
+}
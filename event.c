@@ -0,0 +1,163 @@
+#include <math.h>
+#include "ScisSos.h"
+
+/** Pending wake-up: an I/O completion or a real-time job release **/
+typedef struct ScisSosEvent
+{
+    ScisSosTime time;        /* Simulated time the process wakes up */
+    unsigned long long seq;  /* Insertion order, keeps equal times FIFO */
+    int pid;                 /* Process waiting for it */
+} ScisSosEvent;
+
+// Order two events: earlier time first, then insertion order
+static int scissos_event_less(const ScisSosEvent *a, const ScisSosEvent *b)
+{
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+// Drop all pending events
+void scissos_event_reset(ScisSosContext *ctx)
+{
+    free(ctx->events);
+    ctx->events = NULL;
+    ctx->event_count = 0;
+    ctx->event_capacity = 0;
+    ctx->event_seq = 0;
+}
+
+// Choose the I/O latency distribution for long syscalls
+int scissos_set_io_latency(ScisSosContext *ctx, int dist, double mean)
+{
+    if (dist < LAT_NONE || dist > LAT_EXP || mean < 0)
+    {
+        fprintf(stderr, "Error: Invalid I/O latency distribution %d (mean %.1f).\n", dist, mean);
+        return -1;
+    }
+
+    ctx->io_dist = dist;
+    ctx->io_mean = mean;
+    return 0;
+}
+
+// Parse "none", "fixed:N", "uniform:N" or "exp:N" and apply it
+int scissos_parse_io_latency(ScisSosContext *ctx, const char *spec)
+{
+    const char *names[] = {"none", "fixed", "uniform", "exp"};
+    const char *colon = strchr(spec, ':');
+    size_t len = colon ? (size_t)(colon - spec) : strlen(spec);
+    double mean = colon ? strtod(colon + 1, NULL) : DEFIOLAT;
+
+    for (int dist = LAT_NONE; dist <= LAT_EXP; dist++)
+    {
+        if (strlen(names[dist]) == len && strncmp(names[dist], spec, len) == 0)
+        {
+            return scissos_set_io_latency(ctx, dist, dist == LAT_NONE ? 0 : mean);
+        }
+    }
+
+    fprintf(stderr, "Error: Unknown I/O latency '%s' (use none, fixed:N, uniform:N or exp:N)\n", spec);
+    return -1;
+}
+
+// Draw one I/O latency from the configured distribution
+static ScisSosTime scissos_io_latency(ScisSosContext *ctx)
+{
+    double u = scissos_rng_double(&ctx->rng);
+
+    switch (ctx->io_dist)
+    {
+    case LAT_FIXED:
+        return (ScisSosTime)ctx->io_mean;
+    case LAT_UNIFORM:
+        return (ScisSosTime)(u * 2.0 * ctx->io_mean);
+    case LAT_EXP:
+        return (ScisSosTime)(-ctx->io_mean * log(1.0 - u));
+    default:
+        return 0;
+    }
+}
+
+// Schedule a blocked process to be woken up at the given time
+int scissos_event_schedule_at(ScisSosContext *ctx, const ScisSosPCB *pcb, ScisSosTime time)
+{
+    if (ctx->event_count == ctx->event_capacity)
+    {
+        int capacity = ctx->event_capacity ? ctx->event_capacity * 2 : MAXPROC;
+        ScisSosEvent *grown = (ScisSosEvent *)realloc(ctx->events, capacity * sizeof(ScisSosEvent));
+        if (!grown)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for event queue.\n");
+            return -1;
+        }
+        ctx->events = grown;
+        ctx->event_capacity = capacity;
+    }
+
+    ScisSosEvent *events = ctx->events;
+    ScisSosEvent ev = {time, ctx->event_seq++, pcb->pid};
+
+    // sift up
+    int i = ctx->event_count++;
+    while (i > 0 && scissos_event_less(&ev, &events[(i - 1) / 2]))
+    {
+        events[i] = events[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    events[i] = ev;
+
+    return 0;
+}
+
+// Schedule the I/O completion of a process that blocked at the current time
+int scissos_event_schedule_io(ScisSosContext *ctx, const ScisSosPCB *pcb)
+{
+    return scissos_event_schedule_at(ctx, pcb, ctx->clock + scissos_io_latency(ctx));
+}
+
+// Time of the earliest pending event, NO_TIME if none
+ScisSosTime scissos_event_next_time(ScisSosContext *ctx)
+{
+    return ctx->event_count > 0 ? ctx->events[0].time : NO_TIME;
+}
+
+// Remove and return the PID of the earliest event due by the current time, EMPTY if none
+int scissos_event_pop_due(ScisSosContext *ctx)
+{
+    ScisSosEvent *events = ctx->events;
+
+    if (ctx->event_count == 0 || events[0].time > ctx->clock)
+    {
+        return EMPTY;
+    }
+
+    int pid = events[0].pid;
+    int event_count = --ctx->event_count;
+    ScisSosEvent last = events[event_count];
+
+    // sift the last event down from the root
+    int i = 0;
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= event_count)
+        {
+            break;
+        }
+        if (child + 1 < event_count && scissos_event_less(&events[child + 1], &events[child]))
+        {
+            child++;
+        }
+        if (!scissos_event_less(&events[child], &last))
+        {
+            break;
+        }
+        events[i] = events[child];
+        i = child;
+    }
+    if (event_count > 0)
+    {
+        events[i] = last;
+    }
+
+    return pid;
+}
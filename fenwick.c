@@ -0,0 +1,96 @@
+#include "scheduling_algo.h"
+
+// Initialise an empty tree
+void scissos_fenwick_init(ScisSosFenwick *tree)
+{
+    tree->sums = NULL;
+    tree->size = 0;
+    tree->total = 0;
+}
+
+// Release tree storage
+void scissos_fenwick_free(ScisSosFenwick *tree)
+{
+    free(tree->sums);
+    scissos_fenwick_init(tree);
+}
+
+// Double the tree until it covers index. Every value lies below the old size, so a new
+// power-of-two node (which sums everything before it) holds the total and the rest are 0.
+static int scissos_fenwick_grow(ScisSosFenwick *tree, int index)
+{
+    int size = tree->size ? tree->size : 1;
+
+    while (size <= index)
+    {
+        size *= 2;
+    }
+
+    long long *sums = (long long *)realloc(tree->sums, (size + 1) * sizeof(long long));
+    if (!sums)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for ticket tree.\n");
+        return -1;
+    }
+
+    for (int i = tree->size + 1; i <= size; i++)
+    {
+        sums[i] = (i & (i - 1)) == 0 ? tree->total : 0;
+    }
+    tree->sums = sums;
+    tree->size = size;
+    return 0;
+}
+
+// Add delta to the value at index in O(log n), growing the tree as needed
+int scissos_fenwick_add(ScisSosFenwick *tree, int index, long long delta)
+{
+    if (index >= tree->size && scissos_fenwick_grow(tree, index) < 0)
+    {
+        return -1;
+    }
+
+    for (int i = index + 1; i <= tree->size; i += i & -i)
+    {
+        tree->sums[i] += delta;
+    }
+    tree->total += delta;
+    return 0;
+}
+
+// Value at index in O(log n)
+long long scissos_fenwick_get(const ScisSosFenwick *tree, int index)
+{
+    if (index >= tree->size)
+    {
+        return 0;
+    }
+
+    // Node i sums (i - lowbit(i), i]; take off the nodes that make up (i - lowbit(i), i - 1]
+    int i = index + 1;
+    int stop = i - (i & -i);
+    long long value = tree->sums[i];
+    for (int j = i - 1; j > stop; j -= j & -j)
+    {
+        value -= tree->sums[j];
+    }
+    return value;
+}
+
+// Index whose cumulative range holds target, for 0 <= target < total, in O(log n):
+// the smallest index whose prefix sum exceeds target
+int scissos_fenwick_find(const ScisSosFenwick *tree, long long target)
+{
+    int pos = 0;
+
+    // size is a power of two, so halving steps descend the implicit tree from the root
+    for (int step = tree->size; step > 0; step >>= 1)
+    {
+        if (pos + step <= tree->size && tree->sums[pos + step] <= target)
+        {
+            pos += step;
+            target -= tree->sums[pos];
+        }
+    }
+    return pos;
+}
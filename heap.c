@@ -0,0 +1,157 @@
+#include "scheduling_algo.h"
+
+// Order two heap nodes: smaller key first, ties broken by lower PID
+static int scissos_heap_less(const ScisSosHeapNode *a, const ScisSosHeapNode *b)
+{
+    return a->key < b->key || (a->key == b->key && a->pid < b->pid);
+}
+
+// Place a node at a heap slot and record the slot in its PCB
+static void scissos_heap_set(ScisSosHeap *heap, int i, ScisSosHeapNode node)
+{
+    heap->nodes[i] = node;
+    node.pcb->heap_pos = i;
+}
+
+// Move the node at slot i up until its parent is smaller
+static void scissos_heap_sift_up(ScisSosHeap *heap, int i)
+{
+    ScisSosHeapNode node = heap->nodes[i];
+
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        if (!scissos_heap_less(&node, &heap->nodes[parent]))
+        {
+            break;
+        }
+        scissos_heap_set(heap, i, heap->nodes[parent]);
+        i = parent;
+    }
+
+    scissos_heap_set(heap, i, node);
+}
+
+// Move the node at slot i down until both children are larger
+static void scissos_heap_sift_down(ScisSosHeap *heap, int i)
+{
+    ScisSosHeapNode node = heap->nodes[i];
+
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= heap->size)
+        {
+            break;
+        }
+        if (child + 1 < heap->size && scissos_heap_less(&heap->nodes[child + 1], &heap->nodes[child]))
+        {
+            child++;
+        }
+        if (!scissos_heap_less(&heap->nodes[child], &node))
+        {
+            break;
+        }
+        scissos_heap_set(heap, i, heap->nodes[child]);
+        i = child;
+    }
+
+    scissos_heap_set(heap, i, node);
+}
+
+// Initialise an empty heap
+void scissos_heap_init(ScisSosHeap *heap)
+{
+    heap->nodes = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+}
+
+// Release heap storage
+void scissos_heap_free(ScisSosHeap *heap)
+{
+    free(heap->nodes);
+    scissos_heap_init(heap);
+}
+
+// Insert a process with the given key
+int scissos_heap_push(ScisSosHeap *heap, ScisSosPCB *pcb, long long key)
+{
+    if (heap->size == heap->capacity)
+    {
+        int capacity = heap->capacity ? heap->capacity * 2 : MAXPROC;
+        ScisSosHeapNode *nodes = (ScisSosHeapNode *)realloc(heap->nodes, capacity * sizeof(ScisSosHeapNode));
+        if (!nodes)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for scheduler heap.\n");
+            return -1;
+        }
+        heap->nodes = nodes;
+        heap->capacity = capacity;
+    }
+
+    ScisSosHeapNode node = {key, pcb->pid, pcb};
+    heap->nodes[heap->size] = node;
+    scissos_heap_sift_up(heap, heap->size++);
+
+    return 0;
+}
+
+// Remove a process from anywhere in the heap
+void scissos_heap_remove(ScisSosHeap *heap, ScisSosPCB *pcb)
+{
+    int i = pcb->heap_pos;
+
+    if (i == EMPTY || i >= heap->size || heap->nodes[i].pcb != pcb)
+    {
+        return;
+    }
+
+    pcb->heap_pos = EMPTY;
+    heap->size--;
+
+    if (i == heap->size)
+    {
+        return;
+    }
+
+    // Fill the hole with the last node and restore heap order
+    scissos_heap_set(heap, i, heap->nodes[heap->size]);
+    if (i > 0 && scissos_heap_less(&heap->nodes[i], &heap->nodes[(i - 1) / 2]))
+    {
+        scissos_heap_sift_up(heap, i);
+    }
+    else
+    {
+        scissos_heap_sift_down(heap, i);
+    }
+}
+
+// Change the key of a process already in the heap (decrease or increase)
+void scissos_heap_update(ScisSosHeap *heap, ScisSosPCB *pcb, long long key)
+{
+    int i = pcb->heap_pos;
+
+    if (i == EMPTY || i >= heap->size || heap->nodes[i].pcb != pcb)
+    {
+        return;
+    }
+
+    long long old_key = heap->nodes[i].key;
+    heap->nodes[i].key = key;
+
+    if (key < old_key)
+    {
+        scissos_heap_sift_up(heap, i);
+    }
+    else
+    {
+        scissos_heap_sift_down(heap, i);
+    }
+}
+
+// PID with the smallest key, EMPTY if the heap is empty
+int scissos_heap_top(const ScisSosHeap *heap)
+{
+    return heap->size > 0 ? heap->nodes[0].pid : EMPTY;
+}
@@ -1,131 +1,284 @@
+#include <unistd.h>
 #include "ScisSos.h"
 #include "scheduling_algo.h"
+#include "trace.h"
+#include "workload.h"
 
 #define NUM_PROCESSES 10
 
 // Function to create 10 processes with different characteristics
-void create_processes(ScisSosProcess *processes[])
+void create_processes(ScisSosContext *ctx, ScisSosProcess *processes[])
 {
-    processes[0] = scissos_proc_create("WebBrowser", 50, 5, PT_IOE);
-    processes[1] = scissos_proc_create("Calculator", 20, 10, PT_CMP);
-    processes[2] = scissos_proc_create("TextEditor", 40, 8, PT_REG);
-    processes[3] = scissos_proc_create("VideoPlayer", 60, 3, PT_IOE);
-    processes[4] = scissos_proc_create("Compiler", 80, 15, PT_CMP);
-    processes[5] = scissos_proc_create("FileManager", 35, 7, PT_REG);
-    processes[6] = scissos_proc_create("Database", 70, 4, PT_IOE);
-    processes[7] = scissos_proc_create("Game", 100, 2, PT_CMP);
-    processes[8] = scissos_proc_create("Terminal", 25, 12, PT_REG);
-    processes[9] = scissos_proc_create("ImageEditor", 55, 6, PT_IOE);
-
-    fprintf(stdout, "\n=== Process Creation Complete ===\n");
-    fprintf(stdout, "Total processes created: %d\n\n", NUM_PROCESSES);
+    processes[0] = scissos_proc_create(ctx, "WebBrowser", 50, 5, PT_IOE);
+    processes[1] = scissos_proc_create(ctx, "Calculator", 20, 10, PT_CMP);
+    processes[2] = scissos_proc_create(ctx, "TextEditor", 40, 8, PT_REG);
+    processes[3] = scissos_proc_create(ctx, "VideoPlayer", 60, 3, PT_IOE);
+    processes[4] = scissos_proc_create(ctx, "Compiler", 80, 15, PT_CMP);
+    processes[5] = scissos_proc_create(ctx, "FileManager", 35, 7, PT_REG);
+    processes[6] = scissos_proc_create(ctx, "Database", 70, 4, PT_IOE);
+    processes[7] = scissos_proc_create(ctx, "Game", 100, 2, PT_CMP);
+    processes[8] = scissos_proc_create(ctx, "Terminal", 25, 12, PT_REG);
+    processes[9] = scissos_proc_create(ctx, "ImageEditor", 55, 6, PT_IOE);
+
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "\n=== Process Creation Complete ===\n");
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "Total processes created: %d\n\n", NUM_PROCESSES);
+}
+
+// Print command line usage
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-l off|summary|decisions|trace] [-t trace_file] [-T trace_records] [-m metrics.csv] [-L io_latency] [-B boost_period] [-c cpus] [-M migration_cost] [-b balance_period] [-A affinity_width] [-Q fixed|adaptive[:N]] [-s seed] [-w workload_file] [-d] <scheduler_name>\n",
+            prog);
+    scissos_print_policies(stderr);
 }
 
 int main(int argc, char *argv[])
 {
-    if (argc != 2)
+    int log_level = LOG_TRACE;
+    char *trace_file = NULL;
+    char *metrics_file = NULL;
+    char *workload_file = NULL;
+    int reap = 0;
+    long trace_records = TRACE_DEFCAP;
+    int have_seed = 0;
+    unsigned long long seed = 0;
+    int opt;
+
+    ScisSosProcess *processes[NUM_PROCESSES] = {NULL};
+    int status = 1;
+
+    ScisSosContext *ctx = scissos_context_create();
+    if (ctx == NULL)
     {
-        fprintf(stderr, "Usage: %s <scheduler_name>\n", argv[0]);
-        fprintf(stdout, "Available schedulers: fcfs, sjf, priority, rr\n");
         return 1;
     }
 
+    while ((opt = getopt(argc, argv, "l:t:T:m:L:B:c:M:b:A:Q:s:w:d")) != -1)
+    {
+        switch (opt)
+        {
+        case 'l':
+            log_level = scissos_parse_log_level(optarg);
+            if (log_level < 0)
+            {
+                fprintf(stderr, "Error: Unknown log level '%s'\n", optarg);
+                usage(argv[0]);
+                goto done;
+            }
+            break;
+        case 't':
+            trace_file = optarg;
+            break;
+        case 'L':
+            if (scissos_parse_io_latency(ctx, optarg) != 0)
+            {
+                goto done;
+            }
+            break;
+        case 'B':
+            if (scissos_set_boost_period(ctx, strtoll(optarg, NULL, 10)) != 0)
+            {
+                goto done;
+            }
+            break;
+        case 'c':
+            if (scissos_set_cpus(ctx, atoi(optarg)) != 0)
+            {
+                goto done;
+            }
+            break;
+        case 'M':
+            if (scissos_set_migration_cost(ctx, strtoll(optarg, NULL, 10)) != 0)
+            {
+                goto done;
+            }
+            break;
+        case 'b':
+            if (scissos_set_balance_period(ctx, strtoll(optarg, NULL, 10)) != 0)
+            {
+                goto done;
+            }
+            break;
+        case 'A':
+            if (scissos_set_affinity_width(ctx, atoi(optarg)) != 0)
+            {
+                goto done;
+            }
+            break;
+        case 'Q':
+            if (scissos_parse_quantum(ctx, optarg) != 0)
+            {
+                goto done;
+            }
+            break;
+        case 'd':
+            reap = 1;
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            have_seed = 1;
+            break;
+        case 'w':
+            workload_file = optarg;
+            break;
+        case 'm':
+            metrics_file = optarg;
+            break;
+        case 'T':
+            trace_records = strtol(optarg, NULL, 10);
+            if (trace_records <= 0 || trace_records > (1L << 31))
+            {
+                fprintf(stderr, "Error: Invalid trace capacity '%s'\n", optarg);
+                goto done;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            goto done;
+        }
+    }
+
+    if (argc - optind != 1)
+    {
+        usage(argv[0]);
+        goto done;
+    }
+    char *scheduler = argv[optind];
+
+    scissos_log_init();
+    scissos_set_log_level(ctx, log_level);
+
     // Step 1: Initialize OS
-    scissos_initialise();
+    scissos_initialise(ctx);
+
+    // A run is reproduced exactly by passing its seed back with -s
+    if (have_seed)
+    {
+        scissos_seed(ctx, seed);
+    }
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "Seed: %llu\n\n", ctx->seed);
+
+    // Record every state transition from process creation onwards
+    if (trace_file != NULL && scissos_trace_open(ctx, trace_file, (uint32_t)trace_records) != 0)
+    {
+        goto done;
+    }
 
     // Step 2: Create processes
-    fprintf(stdout, "=== Creating Processes ===\n\n");
-    ScisSosProcess *processes[NUM_PROCESSES];
-    create_processes(processes);
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "=== Creating Processes ===\n\n");
+    if (workload_file != NULL)
+    {
+        // A saved workload replays the same processes and code for every policy
+        int loaded = scissos_workload_load(ctx, workload_file);
+        if (loaded < 0)
+        {
+            goto done;
+        }
+        SCISSOS_LOG(ctx, LOG_SUMMARY, "Loaded %d processes from %s\n\n", loaded, workload_file);
+    }
+    else
+    {
+        create_processes(ctx, processes);
+    }
+
+    // Periodic processes come with a verdict on whether their deadlines can be met
+    if (ctx->rt_count > 0 && SCISSOS_LOG_ON(ctx, LOG_SUMMARY))
+    {
+        scissos_rt_check(ctx, ctx->log_out);
+        fprintf(ctx->log_out, "\n");
+    }
 
     // Step 3: Print initial PCBs
-    fprintf(stdout, "=== Initial Process Control Blocks ===\n");
-    for (int i = 0; i < NUM_PROCESSES; i++)
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "=== Initial Process Control Blocks ===\n");
+    for (int i = 0; i < NUM_PROCESSES && SCISSOS_LOG_ON(ctx, LOG_DECISIONS); i++)
     {
         if (processes[i])
         {
             scissos_print_pcb(processes[i], stdout);
-            fprintf(stdout, "\n");
+            SCISSOS_LOG(ctx, LOG_DECISIONS, "\n");
         }
     }
 
-    // Validate scheduler choice
-    int valid_scheduler = 0;
-    if (strcmp(argv[1], "fcfs") == 0 || strcmp(argv[1], "sjf") == 0 ||
-        strcmp(argv[1], "priority") == 0 || strcmp(argv[1], "rr") == 0)
-    {
-        valid_scheduler = 1;
-    }
+    // Completed processes are deleted immediately with -d
+    scissos_set_reap(ctx, reap);
 
-    if (!valid_scheduler)
+    // Validate scheduler choice
+    if (scissos_set_scheduler(ctx, scheduler) != 0)
     {
-        fprintf(stderr, "Error: Unknown scheduler '%s'\n", argv[1]);
-        fprintf(stdout, "Available schedulers: fcfs, sjf, priority, rr\n");
-        return 1;
+        goto done;
     }
 
     // Step 4: Start scheduling loop
-    fprintf(stdout, "=== Starting Scheduling with '%s' Algorithm ===\n", argv[1]);
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "=== Starting Scheduling with '%s' Algorithm ===\n", scheduler);
 
-    // Loop until all processes are completed
-    int iteration = 0;
-    while (scisos_active_processes())
+    // Dispatch until all processes are completed
+    long dispatches = scissos_run_dispatcher(ctx);
+    if (dispatches < 0)
     {
-        iteration++;
-        fprintf(stdout, "\n--- Scheduling Iteration %d ---\n", iteration);
-
-        scissos_call_scheduler(argv[1]);
-
-        // Safety check to prevent infinite loops during development
-        if (iteration > 10000)
-        {
-            fprintf(stderr, "\n[ERROR] Maximum iterations exceeded!\n");
-            fprintf(stderr, "Possible infinite loop detected.\n");
-            break;
-        }
+        goto done;
     }
 
-    printf("\n[INFO] All processes completed after %d scheduling iterations\n", iteration);
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "\n[INFO] All processes completed after %ld scheduling iterations\n", dispatches);
 
     // Step 5: Final statistics
-    fprintf(stdout, "\n=== Final Statistics ===\n");
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "\n=== Final Statistics ===\n");
 
-    fprintf(stdout, "=== Final Process States ===\n");
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "=== Final Process States ===\n");
     const char *state_str[] = {"NEW", "READY", "RUNNING", "BLOCKED",
                                "SUSP_READY", "SUSP_BLOCKED", "DEAD"};
 
     int dead_count = 0, active_count = 0;
-    for (int i = 0; i < MAXPROC; i++)
+    for (int i = 0; i < ctx->proc_capacity; i++)
     {
-        if (_proctable[i] != NULL)
+        ScisSosPCB *pcb = ctx->proctable[i];
+        if (pcb != NULL)
         {
-            fprintf(stdout, "Process %d: %s (PC=%d/%d)\n",
-                    _proctable[i]->pid, state_str[_proctable[i]->ps_state],
-                    _proctable[i]->pc, _proctable[i]->size);
+            SCISSOS_LOG(ctx, LOG_DECISIONS, "Process %d: %s (PC=%d/%d)\n",
+                        pcb->pid, state_str[pcb->ps_state], pcb->pc, pcb->size);
 
-            if (_proctable[i]->ps_state == PS_DEAD)
+            if (pcb->ps_state == PS_DEAD)
                 dead_count++;
             else
                 active_count++;
         }
     }
 
-    fprintf(stdout, "\nCompleted Processes: %d\n", dead_count);
-    fprintf(stdout, "Active Processes: %d\n", active_count);
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "\nCompleted Processes: %d\n", dead_count);
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "Active Processes: %d\n", active_count);
 
-    // Step 6: Cleanup
-    fprintf(stdout, "\n=== Cleaning up resources ===\n");
+    // Turnaround, waiting and response times, utilisation and throughput
+    if (SCISSOS_LOG_ON(ctx, LOG_SUMMARY))
+    {
+        scissos_metrics_report(ctx, stdout, scheduler, SCISSOS_LOG_ON(ctx, LOG_DECISIONS));
+    }
 
-    // Delete all processes
-    for (int i = 0; i < MAXPROC; i++)
+    if (metrics_file != NULL)
     {
-        if (_proctable[i] != NULL)
+        FILE *csv = fopen(metrics_file, "w");
+        if (csv == NULL || scissos_metrics_export_csv(ctx, csv) != 0)
         {
-            int pid = _proctable[i]->pid;
-            scissos_proc_delete(pid);
+            fprintf(stderr, "Error: Cannot write metrics to '%s'\n", metrics_file);
+        }
+        if (csv != NULL)
+        {
+            fclose(csv);
         }
     }
 
-    fprintf(stdout, "\nSimulation terminated successfully.\n\n");
-    return 0;
+    // Step 6: Cleanup
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "\n=== Cleaning up resources ===\n");
+
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "\nSimulation terminated successfully.\n\n");
+    status = 0;
+
+done:
+    // Delete all processes and release their code in bulk, close the trace and free the
+    // simulation; failures after start-up come here too
+    scissos_shutdown(ctx);
+    for (int i = 0; i < NUM_PROCESSES; i++)
+    {
+        free(processes[i]);
+    }
+    scissos_context_destroy(ctx);
+    return status;
 }
\ No newline at end of file
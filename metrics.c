@@ -0,0 +1,343 @@
+#include <math.h>
+#include "ScisSos.h"
+
+/** Distribution summary of one metric **/
+typedef struct
+{
+    double mean, p50, p95, p99, max;
+} ScisSosSummary;
+
+// Forget all completed processes
+void scissos_metrics_reset(ScisSosContext *ctx)
+{
+    free(ctx->completed);
+    ctx->completed = NULL;
+    ctx->completed_count = 0;
+    ctx->completed_capacity = 0;
+    free(ctx->lateness);
+    ctx->lateness = NULL;
+    ctx->job_count = 0;
+    ctx->job_capacity = 0;
+    ctx->deadline_misses = 0;
+}
+
+// Record a process that just completed
+void scissos_metrics_record(ScisSosContext *ctx, const ScisSosPCB *pcb)
+{
+    if (ctx->completed_count == ctx->completed_capacity)
+    {
+        int capacity = ctx->completed_capacity ? ctx->completed_capacity * 2 : 64;
+        ScisSosProcStats *grown = (ScisSosProcStats *)realloc(ctx->completed, capacity * sizeof(ScisSosProcStats));
+        if (!grown)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for process metrics.\n");
+            return;
+        }
+        ctx->completed = grown;
+        ctx->completed_capacity = capacity;
+    }
+
+    ScisSosProcStats *s = &ctx->completed[ctx->completed_count++];
+    s->pid = pcb->pid;
+    s->uid = pcb->uid;
+    s->p_type = pcb->p_type;
+    s->priority_value = pcb->priority_value;
+    s->size = pcb->size;
+    s->arrival = pcb->t_arrival;
+    s->first_run = pcb->t_first_run;
+    s->completion = pcb->t_completion;
+    s->ready = pcb->t_ready;
+    s->blocked = pcb->t_blocked;
+    s->entitled = pcb->entitled;
+    s->quanta = pcb->quanta;
+    s->preemptions = pcb->preemptions;
+}
+
+// Record the lateness of a real-time job that completed at the current time
+void scissos_metrics_record_job(ScisSosContext *ctx, const ScisSosPCB *pcb)
+{
+    if (ctx->job_count == ctx->job_capacity)
+    {
+        int capacity = ctx->job_capacity ? ctx->job_capacity * 2 : 64;
+        long long *grown = (long long *)realloc(ctx->lateness, capacity * sizeof(long long));
+        if (!grown)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for job metrics.\n");
+            return;
+        }
+        ctx->lateness = grown;
+        ctx->job_capacity = capacity;
+    }
+
+    long long lateness = (long long)(ctx->clock - pcb->t_deadline);
+    ctx->lateness[ctx->job_count++] = lateness;
+    ctx->deadline_misses += lateness > 0;
+}
+
+// Number of completed processes recorded
+int scissos_metrics_count(ScisSosContext *ctx)
+{
+    return ctx->completed_count;
+}
+
+// Nearest-rank percentile of sorted values
+double scissos_percentile(const double *sorted, int n, double p)
+{
+    if (n <= 0)
+    {
+        return 0.0;
+    }
+
+    int rank = (int)ceil(p / 100.0 * n);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    return sorted[(rank > n ? n : rank) - 1];
+}
+
+// qsort comparator for doubles
+static int scissos_cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Sort values and summarise them
+static ScisSosSummary scissos_summarise(double *values, int n)
+{
+    ScisSosSummary s = {0, 0, 0, 0, 0};
+    if (n <= 0)
+    {
+        return s;
+    }
+
+    qsort(values, n, sizeof(double), scissos_cmp_double);
+    for (int i = 0; i < n; i++)
+    {
+        s.mean += values[i];
+    }
+    s.mean /= n;
+    s.p50 = scissos_percentile(values, n, 50);
+    s.p95 = scissos_percentile(values, n, 95);
+    s.p99 = scissos_percentile(values, n, 99);
+    s.max = values[n - 1];
+
+    return s;
+}
+
+// Deviation of the CPU a process used from what its tickets entitled it to, percent
+static double scissos_share_error(const ScisSosProcStats *s)
+{
+    return s->entitled > 0 ? 100.0 * fabs(s->size - s->entitled) / s->entitled : 0.0;
+}
+
+// Print one summary row
+static void scissos_print_summary(FILE *out, const char *name, ScisSosSummary s)
+{
+    fprintf(out, "%-16s %12.1f %12.1f %12.1f %12.1f %12.1f\n",
+            name, s.mean, s.p50, s.p95, s.p99, s.max);
+}
+
+// Print per-process and aggregate turnaround, waiting and response times
+void scissos_metrics_report(ScisSosContext *ctx, FILE *out, const char *scheduler, int per_process)
+{
+    const char *type_names[] = {"REGULAR", "COMPUTE", "IO"};
+    const ScisSosProcStats *completed = ctx->completed;
+    int n = ctx->completed_count;
+
+    fprintf(out, "\n=== Scheduling Metrics (%s) ===\n", scheduler);
+
+    if (per_process && n > 0)
+    {
+        fprintf(out, "%6s %-8s %8s %12s %12s %12s %12s %12s %12s\n",
+                "PID", "Type", "Size", "Arrival", "Completion", "Turnaround", "Waiting", "Response", "Entitled");
+        for (int i = 0; i < n; i++)
+        {
+            const ScisSosProcStats *s = &completed[i];
+            fprintf(out, "%6d %-8s %8d %12llu %12llu %12llu %12llu %12llu %12.0f\n",
+                    s->pid, type_names[s->p_type], s->size, s->arrival, s->completion,
+                    s->completion - s->arrival, s->ready, s->first_run - s->arrival, s->entitled);
+        }
+        fprintf(out, "\n");
+    }
+
+    if (n == 0)
+    {
+        fprintf(out, "No processes completed\n");
+        return;
+    }
+
+    double *turnaround = (double *)malloc(4 * n * sizeof(double));
+    if (!turnaround)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for metrics report.\n");
+        return;
+    }
+    double *waiting = turnaround + n;
+    double *response = waiting + n;
+    double *share = response + n;
+
+    for (int i = 0; i < n; i++)
+    {
+        const ScisSosProcStats *s = &completed[i];
+        turnaround[i] = (double)(s->completion - s->arrival);
+        waiting[i] = (double)s->ready;
+        response[i] = (double)(s->first_run - s->arrival);
+        share[i] = scissos_share_error(s);
+    }
+
+    fprintf(out, "%-16s %12s %12s %12s %12s %12s\n", "Metric (ticks)", "mean", "p50", "p95", "p99", "max");
+    scissos_print_summary(out, "Turnaround", scissos_summarise(turnaround, n));
+    scissos_print_summary(out, "Waiting", scissos_summarise(waiting, n));
+    scissos_print_summary(out, "Response", scissos_summarise(response, n));
+
+    ScisSosRunSummary sum;
+    scissos_metrics_summary(ctx, &sum);
+    fprintf(out, "\nCompleted processes: %d\n", n);
+    fprintf(out, "Makespan: %llu ticks (idle %llu)\n", sum.makespan, ctx->idle_ticks);
+    fprintf(out, "CPU utilisation: %.2f%%\n", sum.utilisation);
+    fprintf(out, "Throughput: %.4f processes per 1000 ticks\n", sum.throughput);
+
+    // how the time slices suited each type: switches it paid and how long a dispatch waited
+    long count[3] = {0, 0, 0}, quanta[3] = {0, 0, 0}, preempted[3] = {0, 0, 0};
+    double ready[3] = {0, 0, 0};
+    for (int i = 0; i < n; i++)
+    {
+        const ScisSosProcStats *s = &completed[i];
+        count[s->p_type]++;
+        quanta[s->p_type] += s->quanta;
+        preempted[s->p_type] += s->preemptions;
+        ready[s->p_type] += (double)s->ready;
+    }
+    fprintf(out, "\n%-8s %8s %12s %12s %12s\n", "Type", "Count", "Quanta", "Preempted", "Latency");
+    for (int t = 0; t < 3; t++)
+    {
+        if (count[t] > 0)
+        {
+            fprintf(out, "%-8s %8ld %12.1f %12.1f %12.1f\n", type_names[t], count[t], (double)quanta[t] / count[t],
+                    (double)preempted[t] / count[t], quanta[t] ? ready[t] / quanta[t] : 0.0);
+        }
+    }
+    fprintf(out, "Preemptions: %ld, latency %.1f ticks per dispatch\n", sum.preemptions, sum.latency);
+
+    // how the work spread over the CPUs, and what moving it cost
+    if (ctx->ncpu > 1)
+    {
+        fprintf(out, "\n%6s %8s %12s %10s %10s %8s %8s\n", "CPU", "Busy (%)", "Overhead", "Dispatches",
+                "Migrations", "Steals", "Balanced");
+        for (int c = 0; c < ctx->ncpu; c++)
+        {
+            const ScisSosCpu *cpu = &ctx->cpus[c];
+            fprintf(out, "%6d %8.2f %12llu %10ld %10ld %8ld %8ld\n", c,
+                    sum.makespan ? 100.0 * cpu->busy_ticks / sum.makespan : 0.0, cpu->overhead_ticks,
+                    cpu->dispatches, cpu->migrations, cpu->steals, cpu->balanced);
+        }
+        fprintf(out, "Migrations: %ld\n", sum.migrations);
+    }
+
+    // CPU used against the share the process's tickets entitled it to while it was runnable
+    fprintf(out, "\n%-16s %12s %12s %12s %12s %12s\n", "Metric (%)", "mean", "p50", "p95", "p99", "max");
+    scissos_print_summary(out, "Share error", scissos_summarise(share, n));
+    fprintf(out, "CPU given beyond entitlement: %.2f%%\n", sum.share_error);
+
+    free(turnaround);
+
+    if (ctx->job_count > 0)
+    {
+        double *lateness = (double *)malloc(ctx->job_count * sizeof(double));
+        if (!lateness)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for metrics report.\n");
+            return;
+        }
+        for (int i = 0; i < ctx->job_count; i++)
+        {
+            lateness[i] = (double)ctx->lateness[i];
+        }
+
+        fprintf(out, "\nReal-time jobs: %d, deadline misses: %d (%.2f%%)\n", ctx->job_count,
+                ctx->deadline_misses, 100.0 * ctx->deadline_misses / ctx->job_count);
+        fprintf(out, "%-16s %12s %12s %12s %12s %12s\n", "Metric (ticks)", "mean", "p50", "p95", "p99", "max");
+        scissos_print_summary(out, "Lateness", scissos_summarise(lateness, ctx->job_count));
+        free(lateness);
+    }
+}
+
+// Mean times, makespan, utilisation of all CPUs and throughput over the completed processes
+void scissos_metrics_summary(ScisSosContext *ctx, ScisSosRunSummary *sum)
+{
+    int n = ctx->completed_count;
+    ScisSosTime busy = 0, first_arrival = NO_TIME, last_completion = 0;
+
+    memset(sum, 0, sizeof(*sum));
+    sum->completed = n;
+    sum->jobs = ctx->job_count;
+    sum->misses = ctx->deadline_misses;
+    for (int c = 0; c < ctx->ncpu; c++)
+    {
+        sum->migrations += ctx->cpus[c].migrations;
+    }
+    for (int i = 0; i < ctx->job_count; i++)
+    {
+        sum->lateness += (double)ctx->lateness[i] / ctx->job_count;
+    }
+    if (n == 0)
+    {
+        return;
+    }
+
+    long quanta = 0;
+    for (int i = 0; i < n; i++)
+    {
+        const ScisSosProcStats *s = &ctx->completed[i];
+        quanta += s->quanta;
+        sum->preemptions += s->preemptions;
+        sum->latency += (double)s->ready;
+        sum->turnaround += (double)(s->completion - s->arrival);
+        sum->waiting += (double)s->ready;
+        sum->response += (double)(s->first_run - s->arrival);
+        sum->share_error += fabs(s->size - s->entitled);
+        busy += s->size;
+        if (s->arrival < first_arrival)
+        {
+            first_arrival = s->arrival;
+        }
+        if (s->completion > last_completion)
+        {
+            last_completion = s->completion;
+        }
+    }
+
+    sum->turnaround /= n;
+    sum->waiting /= n;
+    sum->response /= n;
+    sum->latency = quanta ? sum->latency / quanta : 0.0;
+    sum->share_error = busy ? 50.0 * sum->share_error / busy : 0.0; // each misplaced tick is counted twice
+    sum->makespan = last_completion - first_arrival;
+    sum->utilisation = sum->makespan ? 100.0 * busy / ((double)sum->makespan * ctx->ncpu) : 100.0;
+    sum->throughput = sum->makespan ? 1000.0 * n / sum->makespan : 0.0;
+}
+
+// Write per-process metrics as CSV
+int scissos_metrics_export_csv(ScisSosContext *ctx, FILE *out)
+{
+    if (out == NULL)
+    {
+        fprintf(stderr, "Error: Invalid metrics output file.\n");
+        return -1;
+    }
+
+    fprintf(out, "pid,uid,type,priority,size,arrival,first_run,completion,turnaround,waiting,response,blocked,entitled,quanta,preemptions\n");
+    for (int i = 0; i < ctx->completed_count; i++)
+    {
+        const ScisSosProcStats *s = &ctx->completed[i];
+        fprintf(out, "%d,%d,%d,%d,%d,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.1f,%d,%d\n",
+                s->pid, s->uid, s->p_type, s->priority_value, s->size,
+                s->arrival, s->first_run, s->completion,
+                s->completion - s->arrival, s->ready, s->first_run - s->arrival, s->blocked, s->entitled,
+                s->quanta, s->preemptions);
+    }
+
+    return 0;
+}
@@ -1,180 +1,839 @@
 #include "scheduling_algo.h"
 #include "time.h"
+#include "trace.h"
+#include "workload.h"
 
-int _currentPID = EMPTY;
-ScisSosPCB *_proctable[MAXPROC] = {NULL};
-int _readyQ[MAXPROC] = {EMPTY};
-int _blockQ[MAXPROC] = {EMPTY};
+// Empty a CPU's run queue and counters, keeping the heap's storage
+static void scissos_cpu_reset(ScisSosCpu *cpu)
+{
+    ScisSosRunQueue *rq = &cpu->rq;
 
-// Initialise the OS
-void scissos_initialise(void)
+    scissos_queue_init(&rq->readyQ);
+    rq->ready_heap.size = 0;
+    for (int l = 0; l < MLFQ_LEVELS; l++)
+    {
+        scissos_queue_init(&rq->mlfq[l]);
+    }
+    rq->mlfq_mask = 0;
+    scissos_rb_init(&rq->cfs_tree);
+    rq->cfs_weight = 0;
+    rq->min_vruntime = 0;
+    for (int u = 0; u <= MAXUSRS; u++)
+    {
+        scissos_rb_init(&rq->users[u].ready);
+    }
+    scissos_rb_init(&rq->user_tree);
+    rq->fshare_seq = 0;
+    scissos_fenwick_free(&rq->lottery);
+
+    cpu->current_pid = EMPTY;
+    cpu->burst_state = PS_RUN;
+    cpu->burst_ticks = 0;
+    cpu->free_at = 0;
+    cpu->busy_ticks = 0;
+    cpu->overhead_ticks = 0;
+    cpu->idle_ticks = 0;
+    cpu->idle_since = 0;
+    cpu->dispatches = 0;
+    cpu->migrations = 0;
+    cpu->steals = 0;
+    cpu->balanced = 0;
+}
+
+// Release a CPU's run queue storage
+static void scissos_cpu_free(ScisSosCpu *cpu)
 {
-    fprintf(stdout, "=== Initialising ScisSOS ===\n");
+    scissos_heap_free(&cpu->rq.ready_heap);
+    scissos_fenwick_free(&cpu->rq.lottery);
+}
 
-    // Process table initialisation
-    for (int i = 0; i < MAXPROC; i++)
+// Allocate a simulation context with default settings; scissos_initialise prepares it for use
+ScisSosContext *scissos_context_create(void)
+{
+    ScisSosContext *ctx = (ScisSosContext *)calloc(1, sizeof(ScisSosContext));
+    if (!ctx)
     {
-        _proctable[i] = NULL;
-        _readyQ[i] = EMPTY;
-        _blockQ[i] = EMPTY;
+        fprintf(stderr, "Error: Memory allocation failed for simulator context.\n");
+        return NULL;
     }
 
-    _currentPID = EMPTY;
+    ctx->cpus = (ScisSosCpu *)calloc(1, sizeof(ScisSosCpu));
+    if (!ctx->cpus)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for simulator context.\n");
+        free(ctx);
+        return NULL;
+    }
+    ctx->ncpu = 1;
+    scissos_heap_init(&ctx->cpus[0].rq.ready_heap);
+    scissos_fenwick_init(&ctx->cpus[0].rq.lottery);
+    scissos_cpu_reset(&ctx->cpus[0]);
+    ctx->rq = &ctx->cpus[0].rq;
 
-    // Seed random number generator
-    srand((unsigned int)time(NULL));
+    ctx->log_level = LOG_TRACE;
+    ctx->log_out = stdout;
+    ctx->io_dist = LAT_EXP;
+    ctx->io_mean = DEFIOLAT;
+    ctx->timeslice = DEFTS;
+    ctx->boost_period = DEFBOOST;
+    ctx->balance_period = DEFBALANCE;
+    scissos_set_quantum(ctx, "fixed", DEFSWITCH);
+    scissos_queue_init(&ctx->blockQ);
 
-    fprintf(stdout, "Process table initialised\n");
-    fprintf(stdout, "Ready and Block Queues initialised\n");
-    fprintf(stdout, "=== ScisSOS Initialised ===\n\n");
+    return ctx;
 }
 
-// Update the ready and block queues
-void scisos_update_queues(void)
+// Shut a simulation down and free everything it owns
+void scissos_context_destroy(ScisSosContext *ctx)
 {
-    /* READY QUEUE UPDATION*/
-    int q_index = 0;
+    if (ctx == NULL)
+    {
+        return;
+    }
 
-    // clear ready queue
-    for (int i = 0; i < MAXPROC; i++)
+    scissos_shutdown(ctx);
+    scissos_trace_close(ctx);
+    scissos_metrics_reset(ctx);
+    for (int c = 0; c < ctx->ncpu; c++)
     {
-        _readyQ[i] = EMPTY;
+        scissos_cpu_free(&ctx->cpus[c]);
     }
+    free(ctx->cpus);
+    free(ctx->proctable);
+    free(ctx->slot_gen);
+    free(ctx->free_slots);
+    free(ctx);
+}
+
+// Initialise the OS
+void scissos_initialise(ScisSosContext *ctx)
+{
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "=== Initialising ScisSOS ===\n");
 
-    // check process table for ready processes
-    for (int i = 0; i < MAXPROC; i++)
+    // Process table initialisation; it grows from MAXPROC slots as needed
+    free(ctx->proctable);
+    free(ctx->slot_gen);
+    free(ctx->free_slots);
+    ctx->proctable = (ScisSosPCB **)calloc(MAXPROC, sizeof(ScisSosPCB *));
+    ctx->slot_gen = (unsigned char *)calloc(MAXPROC, sizeof(unsigned char));
+    ctx->free_slots = (int *)malloc(MAXPROC * sizeof(int));
+    ctx->proc_capacity = ctx->proctable && ctx->slot_gen && ctx->free_slots ? MAXPROC : 0;
+    ctx->proc_count = 0;
+    ctx->free_count = 0;
+    ctx->slot_high = 0;
+
+    scissos_queue_init(&ctx->blockQ);
+    ctx->active_count = 0;
+    ctx->ready_count = 0;
+    ctx->clock = 0;
+    ctx->idle_ticks = 0;
+    scissos_metrics_reset(ctx);
+    scissos_event_reset(ctx);
+    for (int c = 0; c < ctx->ncpu; c++)
     {
-        ScisSosPCB *pcb = _proctable[i];
+        scissos_cpu_reset(&ctx->cpus[c]);
+    }
+    ctx->rq = &ctx->cpus[0].rq;
+    ctx->next_balance = ctx->balance_period;
+    scissos_quantum_reset(ctx);
+    ctx->mlfq_epoch = 0;
+    ctx->next_boost = ctx->boost_period;
+    memset(ctx->user_usage, 0, sizeof(ctx->user_usage));
+    ctx->min_usage = 0;
+    ctx->share_tickets = 0;
+    ctx->share_pass = 0;
+    ctx->rt_count = 0;
+    ctx->rt_util = 0;
+    ctx->rt_density = 0;
+    ctx->policy = NULL;
+    ctx->reap_dead = 0;
 
-        if (pcb != NULL && pcb->ps_state == PS_RDY)
+    // Seed random number generator
+    scissos_seed(ctx, (unsigned long long)time(NULL));
+
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "Process table initialised\n");
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "Ready and Block Queues initialised\n");
+    SCISSOS_LOG(ctx, LOG_SUMMARY, "=== ScisSOS Initialised ===\n\n");
+}
+
+// Switch stdout to one large buffer for log output; not thread-safe, call before any simulation runs
+void scissos_log_init(void)
+{
+    static char log_buffer[LOG_BUFSIZE];
+
+    fflush(stdout);
+    setvbuf(stdout, log_buffer, _IOFBF, sizeof(log_buffer));
+}
+
+// Set the runtime log level of a simulation
+void scissos_set_log_level(ScisSosContext *ctx, int level)
+{
+    ctx->log_level = level;
+}
+
+// Set the master seed; the same seed and workload reproduce a run bit for bit
+void scissos_seed(ScisSosContext *ctx, unsigned long long seed)
+{
+    ctx->seed = seed;
+    scissos_rng_seed(&ctx->rng, seed, 0);
+    scissos_rng_seed(&ctx->lottery_rng, seed, ~0ULL); // a stream no PID uses
+}
+
+// Convert a log level name to its constant, -1 if unknown
+int scissos_parse_log_level(const char *name)
+{
+    const char *names[] = {"off", "summary", "decisions", "trace"};
+
+    for (int i = LOG_OFF; i <= LOG_TRACE; i++)
+    {
+        if (strcmp(names[i], name) == 0)
         {
-            _readyQ[q_index++] = pcb->pid;
+            return i;
         }
     }
+    return -1;
+}
 
-    /* BLOCK QUEUE UPDATION*/
-    int b_index = 0;
+// Double the process table and its slot bookkeeping
+static int scissos_grow_table(ScisSosContext *ctx)
+{
+    int capacity = ctx->proc_capacity ? ctx->proc_capacity * 2 : MAXPROC;
+    if (capacity > PID_SLOT_MASK)
+    {
+        capacity = PID_SLOT_MASK;
+    }
+    if (capacity <= ctx->proc_capacity)
+    {
+        return -1;
+    }
 
-    // clear block queue
-    for (int i = 0; i < MAXPROC; i++)
+    ScisSosPCB **table = (ScisSosPCB **)realloc(ctx->proctable, capacity * sizeof(ScisSosPCB *));
+    if (!table)
     {
-        _blockQ[i] = EMPTY;
+        return -1;
     }
+    ctx->proctable = table;
 
-    // check process table for blocked processes
-    for (int i = 0; i < MAXPROC; i++)
+    unsigned char *gen = (unsigned char *)realloc(ctx->slot_gen, capacity * sizeof(unsigned char));
+    if (!gen)
     {
-        ScisSosPCB *pcb = _proctable[i];
+        return -1;
+    }
+    ctx->slot_gen = gen;
 
-        if (pcb != NULL && pcb->ps_state == PS_BLK)
+    int *slots = (int *)realloc(ctx->free_slots, capacity * sizeof(int));
+    if (!slots)
+    {
+        return -1;
+    }
+    ctx->free_slots = slots;
+
+    memset(ctx->proctable + ctx->proc_capacity, 0, (capacity - ctx->proc_capacity) * sizeof(ScisSosPCB *));
+    memset(ctx->slot_gen + ctx->proc_capacity, 0, (capacity - ctx->proc_capacity) * sizeof(unsigned char));
+    ctx->proc_capacity = capacity;
+
+    return 0;
+}
+
+// Reserve a process table slot and return the PID naming it, EMPTY if full
+int scissos_pid_alloc(ScisSosContext *ctx)
+{
+    int slot;
+
+    if (ctx->free_count > 0)
+    {
+        slot = ctx->free_slots[--ctx->free_count];
+    }
+    else
+    {
+        if (ctx->slot_high == ctx->proc_capacity && scissos_grow_table(ctx) != 0)
         {
-            _blockQ[b_index++] = pcb->pid;
+            return EMPTY;
         }
+        slot = ctx->slot_high++;
     }
+
+    ctx->proc_count++;
+    return (ctx->slot_gen[slot] << PID_SLOT_BITS) | (slot + 1);
 }
 
-// count ready processes
-int scissos_count_ready_processes(void)
+// Free a PID's slot; the next PID using it carries a new generation
+void scissos_pid_release(ScisSosContext *ctx, int pid)
+{
+    int slot = PID_SLOT(pid);
+
+    if (slot < 0 || slot >= ctx->slot_high)
+    {
+        return;
+    }
+
+    ctx->proctable[slot] = NULL;
+    ctx->slot_gen[slot] = (ctx->slot_gen[slot] + 1) & PID_GEN_MASK;
+    ctx->free_slots[ctx->free_count++] = slot;
+    ctx->proc_count--;
+}
+
+// PCB of a PID, NULL if out of range, free, or from an older generation
+ScisSosPCB *scissos_pcb_lookup(ScisSosContext *ctx, int pid)
+{
+    if (pid < 1)
+    {
+        return NULL;
+    }
+
+    int slot = PID_SLOT(pid);
+    if (slot < 0 || slot >= ctx->slot_high)
+    {
+        return NULL;
+    }
+
+    ScisSosPCB *pcb = ctx->proctable[slot];
+    return pcb != NULL && pcb->pid == pid ? pcb : NULL;
+}
+
+// Delete processes as soon as they complete (metrics are kept)
+void scissos_set_reap(ScisSosContext *ctx, int reap)
+{
+    ctx->reap_dead = reap;
+}
+
+// Set the time slice given to processes created from now on
+int scissos_set_timeslice(ScisSosContext *ctx, int timeslice)
+{
+    if (timeslice <= 0)
+    {
+        fprintf(stderr, "Error: Invalid time slice %d. Must be positive.\n", timeslice);
+        return -1;
+    }
+
+    ctx->timeslice = timeslice;
+    return 0;
+}
+
+// Set how often MLFQ lifts every process back to its top level
+int scissos_set_boost_period(ScisSosContext *ctx, long long period)
 {
-    int count = 0;
+    if (period <= 0)
+    {
+        fprintf(stderr, "Error: Invalid boost period %lld. Must be positive.\n", period);
+        return -1;
+    }
+
+    ctx->boost_period = (ScisSosTime)period;
+    ctx->next_boost = ctx->clock + ctx->boost_period;
+    return 0;
+}
 
-    for (int i = 0; i < MAXPROC; i++)
+// Set the number of simulated CPUs, each with its own run queue; only while the process
+// table is empty
+int scissos_set_cpus(ScisSosContext *ctx, int ncpu)
+{
+    if (ncpu < 1 || ncpu > MAXCPUS)
+    {
+        fprintf(stderr, "Error: Invalid CPU count %d. Must be between 1 and %d.\n", ncpu, MAXCPUS);
+        return -1;
+    }
+    if (ctx->proc_count > 0)
     {
-        if (_readyQ[i] != EMPTY)
+        fprintf(stderr, "Error: CPU count cannot change while processes exist.\n");
+        return -1;
+    }
+
+    for (int c = ncpu; c < ctx->ncpu; c++)
+    {
+        scissos_cpu_free(&ctx->cpus[c]);
+    }
+    ScisSosCpu *cpus = (ScisSosCpu *)realloc(ctx->cpus, ncpu * sizeof(ScisSosCpu));
+    if (!cpus)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for CPUs.\n");
+        ctx->ncpu = ncpu < ctx->ncpu ? ncpu : ctx->ncpu;
+        return -1;
+    }
+    for (int c = ctx->ncpu; c < ncpu; c++)
+    {
+        scissos_heap_init(&cpus[c].rq.ready_heap);
+        scissos_fenwick_init(&cpus[c].rq.lottery);
+    }
+    ctx->cpus = cpus;
+    ctx->ncpu = ncpu;
+    for (int c = 0; c < ncpu; c++)
+    {
+        scissos_cpu_reset(&ctx->cpus[c]);
+    }
+    ctx->rq = &ctx->cpus[0].rq;
+    return 0;
+}
+
+// Set the ticks a CPU loses before running a process whose cache state is on another CPU
+int scissos_set_migration_cost(ScisSosContext *ctx, long long cost)
+{
+    if (cost < 0)
+    {
+        fprintf(stderr, "Error: Invalid migration cost %lld. Must not be negative.\n", cost);
+        return -1;
+    }
+
+    ctx->migration_cost = (ScisSosTime)cost;
+    return 0;
+}
+
+// Set how often SMP load balancing evens out the run queues
+int scissos_set_balance_period(ScisSosContext *ctx, long long period)
+{
+    if (period <= 0)
+    {
+        fprintf(stderr, "Error: Invalid balance period %lld. Must be positive.\n", period);
+        return -1;
+    }
+
+    ctx->balance_period = (ScisSosTime)period;
+    ctx->next_balance = ctx->clock + ctx->balance_period;
+    return 0;
+}
+
+// Restrict processes created from now on to width consecutive CPUs, spread by table slot
+int scissos_set_affinity_width(ScisSosContext *ctx, int width)
+{
+    if (width < 0 || width > MAXCPUS)
+    {
+        fprintf(stderr, "Error: Invalid affinity width %d. Must be between 0 and %d.\n", width, MAXCPUS);
+        return -1;
+    }
+
+    ctx->affinity_width = width;
+    return 0;
+}
+
+// Generate the code of processes created from now on in CODE_CHUNK windows as they run,
+// so memory per process stays constant however large it is
+void scissos_set_lazy_code(ScisSosContext *ctx, int lazy)
+{
+    ctx->lazy_code = lazy;
+}
+
+// Empty a queue
+void scissos_queue_init(ScisSosQueue *q)
+{
+    q->head = EMPTY;
+    q->tail = EMPTY;
+    q->count = 0;
+}
+
+// Append a process at the tail of a queue
+void scissos_queue_push(ScisSosContext *ctx, ScisSosQueue *q, ScisSosPCB *pcb)
+{
+    pcb->q_next = EMPTY;
+    pcb->q_prev = q->tail;
+
+    if (q->tail != EMPTY)
+    {
+        PCB_OF(ctx, q->tail)->q_next = pcb->pid;
+    }
+    else
+    {
+        q->head = pcb->pid;
+    }
+
+    q->tail = pcb->pid;
+    q->count++;
+}
+
+// Insert a process at the head of a queue
+void scissos_queue_push_front(ScisSosContext *ctx, ScisSosQueue *q, ScisSosPCB *pcb)
+{
+    pcb->q_prev = EMPTY;
+    pcb->q_next = q->head;
+
+    if (q->head != EMPTY)
+    {
+        PCB_OF(ctx, q->head)->q_prev = pcb->pid;
+    }
+    else
+    {
+        q->tail = pcb->pid;
+    }
+
+    q->head = pcb->pid;
+    q->count++;
+}
+
+// Unlink a process from anywhere in a queue
+void scissos_queue_remove(ScisSosContext *ctx, ScisSosQueue *q, ScisSosPCB *pcb)
+{
+    if (pcb->q_prev != EMPTY)
+    {
+        PCB_OF(ctx, pcb->q_prev)->q_next = pcb->q_next;
+    }
+    else
+    {
+        q->head = pcb->q_next;
+    }
+
+    if (pcb->q_next != EMPTY)
+    {
+        PCB_OF(ctx, pcb->q_next)->q_prev = pcb->q_prev;
+    }
+    else
+    {
+        q->tail = pcb->q_prev;
+    }
+
+    pcb->q_next = EMPTY;
+    pcb->q_prev = EMPTY;
+    q->count--;
+}
+
+// Queue holding processes in the given state, NULL if the state has none
+static ScisSosQueue *scissos_state_queue(ScisSosContext *ctx, int state)
+{
+    switch (state)
+    {
+    case PS_RDY:
+        return &ctx->rq->readyQ;
+    case PS_BLK:
+        return &ctx->blockQ;
+    default:
+        return NULL;
+    }
+}
+
+// check whether a state counts as active
+static int scissos_state_active(int state)
+{
+    return state == PS_RDY || state == PS_RUN || state == PS_BLK ||
+           state == PS_SRDY || state == PS_SBLK;
+}
+
+// Processes waiting for or running on a CPU
+static int scissos_cpu_load(ScisSosContext *ctx, int cpu)
+{
+    return ctx->cpus[cpu].rq.readyQ.count + (ctx->cpus[cpu].current_pid != EMPTY);
+}
+
+// CPUs a process may run on; an affinity naming no simulated CPU is ignored
+unsigned long long scissos_allowed_cpus(ScisSosContext *ctx, const ScisSosPCB *pcb)
+{
+    unsigned long long all = ctx->ncpu < 64 ? (1ULL << ctx->ncpu) - 1 : ~0ULL;
+    unsigned long long allowed = pcb->affinity & all;
+    return allowed != 0 ? allowed : all;
+}
+
+// CPU for a process becoming ready: the one it last ran on, whose cache may still be warm,
+// unless that has more than one process more than the least loaded CPU it may use
+int scissos_select_cpu(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    unsigned long long allowed = scissos_allowed_cpus(ctx, pcb);
+    int best = EMPTY, best_load = 0;
+
+    for (int c = 0; c < ctx->ncpu; c++)
+    {
+        int load = scissos_cpu_load(ctx, c);
+        if ((allowed >> c & 1) && (best == EMPTY || load < best_load))
         {
-            count++;
+            best = c;
+            best_load = load;
         }
     }
 
-    return count;
+    int last = pcb->last_cpu;
+    if (last != EMPTY && (allowed >> last & 1) && scissos_cpu_load(ctx, last) <= best_load + 1)
+    {
+        return last;
+    }
+    return best;
 }
 
-// check for active processes
-int scisos_active_processes(void)
+// Move a ready process to another CPU's run queue; -1 if the policy could not queue it there
+int scissos_migrate(ScisSosContext *ctx, ScisSosPCB *pcb, int cpu)
 {
-    for (int i = 0; i < MAXPROC; i++)
+    ctx->rq = &ctx->cpus[pcb->cpu].rq;
+    scissos_queue_remove(ctx, &ctx->rq->readyQ, pcb);
+    if (ctx->policy != NULL && ctx->policy->on_unready != NULL)
+    {
+        ctx->policy->on_unready(ctx, pcb);
+    }
+
+    pcb->cpu = cpu;
+    ctx->rq = &ctx->cpus[cpu].rq;
+    scissos_queue_push(ctx, &ctx->rq->readyQ, pcb);
+    if (ctx->policy != NULL && ctx->policy->on_ready != NULL)
+    {
+        return ctx->policy->on_ready(ctx, pcb);
+    }
+    return 0;
+}
+
+// check whether a state can use the CPU, so that its tickets earn a share of it
+static int scissos_state_runnable(int state)
+{
+    return state == PS_RDY || state == PS_RUN;
+}
+
+// Credit a runnable process with the CPU its tickets earned since it was last settled
+static void scissos_share_settle(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    pcb->entitled += (double)pcb->tickets * (ctx->share_pass - pcb->share_mark) / (1LL << SHARE_SHIFT);
+    pcb->share_mark = ctx->share_pass;
+}
+
+// Move a process to a new state, keeping queues and counters up to date. Returns -1 if the
+// policy ran out of memory queueing a ready process: it is in the ready queue but cannot be
+// picked, so the run must stop.
+int scissos_set_state(ScisSosContext *ctx, ScisSosPCB *pcb, int state)
+{
+    int old_state = pcb->ps_state;
+
+    if (old_state == state)
+    {
+        return 0;
+    }
+
+    ctx->rq = &ctx->cpus[pcb->cpu].rq;
+
+    ScisSosQueue *old_q = scissos_state_queue(ctx, old_state);
+    if (old_q != NULL)
+    {
+        scissos_queue_remove(ctx, old_q, pcb);
+    }
+
+    if (old_state == PS_RDY && ctx->policy != NULL && ctx->policy->on_unready != NULL)
+    {
+        ctx->policy->on_unready(ctx, pcb);
+    }
+
+    ctx->active_count += scissos_state_active(state) - scissos_state_active(old_state);
+    ctx->ready_count += (state == PS_RDY) - (old_state == PS_RDY);
+    pcb->ps_state = state;
+
+    // Charge the time since the last transition to the state being left
+    ScisSosTime elapsed = ctx->clock - pcb->t_last;
+    if (old_state == PS_RDY)
+    {
+        pcb->t_ready += elapsed;
+    }
+    else if (old_state == PS_BLK)
+    {
+        pcb->t_blocked += elapsed;
+    }
+    pcb->t_last = ctx->clock;
+
+    // Entitlement accrues only while the process is runnable
+    int runnable = scissos_state_runnable(state);
+    if (runnable && !scissos_state_runnable(old_state))
+    {
+        pcb->share_mark = ctx->share_pass;
+        ctx->share_tickets += pcb->tickets;
+    }
+    else if (!runnable && scissos_state_runnable(old_state))
     {
-        ScisSosPCB *pcb = _proctable[i];
-        if (pcb != NULL)
+        scissos_share_settle(ctx, pcb);
+        ctx->share_tickets -= pcb->tickets;
+    }
+
+    if (state == PS_RUN)
+    {
+        pcb->quanta++;
+        if (pcb->t_first_run == NO_TIME)
         {
-            int state = pcb->ps_state;
+            pcb->t_first_run = ctx->clock;
+        }
+    }
+    else if (state == PS_DEAD && pcb->pc >= pcb->size)
+    {
+        pcb->t_completion = ctx->clock;
+        scissos_metrics_record(ctx, pcb);
+    }
+
+    scissos_trace_record(ctx, pcb->pid, old_state, state, pcb->pc);
+
+    // A process becoming ready other than at the end of its quantum, or whose affinity
+    // changed while it ran, picks a CPU afresh
+    if (state == PS_RDY && ctx->ncpu > 1 &&
+        (old_state != PS_RUN || !(scissos_allowed_cpus(ctx, pcb) >> pcb->cpu & 1)))
+    {
+        pcb->cpu = scissos_select_cpu(ctx, pcb);
+        ctx->rq = &ctx->cpus[pcb->cpu].rq;
+    }
+
+    ScisSosQueue *new_q = scissos_state_queue(ctx, state);
+    if (new_q != NULL)
+    {
+        scissos_queue_push(ctx, new_q, pcb);
+    }
 
-            if (state == PS_RDY || state == PS_RUN || state == PS_BLK ||
-                state == PS_SRDY || state == PS_SBLK)
+    if (state == PS_RDY && ctx->policy != NULL && ctx->policy->on_ready != NULL)
+    {
+        return ctx->policy->on_ready(ctx, pcb);
+    }
+    return 0;
+}
+
+// Tell the active policy that a ready process changed its scheduling key
+void scissos_ready_update(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    if (pcb->ps_state == PS_RDY && ctx->policy != NULL && ctx->policy->on_update != NULL)
+    {
+        ctx->rq = &ctx->cpus[pcb->cpu].rq;
+        ctx->policy->on_update(ctx, pcb);
+    }
+}
+
+// Change a process's tickets; a runnable one first banks what the old count earned
+void scissos_set_tickets(ScisSosContext *ctx, ScisSosPCB *pcb, int tickets)
+{
+    if (scissos_state_runnable(pcb->ps_state))
+    {
+        scissos_share_settle(ctx, pcb);
+        ctx->share_tickets += tickets - pcb->tickets;
+    }
+    pcb->tickets = tickets;
+}
+
+// Select the scheduling policy; processes already ready are handed over to it
+int scissos_set_scheduler(ScisSosContext *ctx, const char *scheduler)
+{
+    const ScisSosPolicy *policy = scissos_find_policy(scheduler);
+
+    if (policy == NULL)
+    {
+        fprintf(stderr, "Error: Unknown scheduler '%s'\n", scheduler);
+        scissos_print_policies(stdout);
+        return -1;
+    }
+
+    for (int c = 0; c < ctx->ncpu; c++)
+    {
+        ctx->rq = &ctx->cpus[c].rq;
+        for (int pid = ctx->rq->readyQ.head; pid != EMPTY; pid = PCB_OF(ctx, pid)->q_next)
+        {
+            if (ctx->policy != NULL && ctx->policy->on_unready != NULL)
             {
-                return 1; // Active process found
+                ctx->policy->on_unready(ctx, PCB_OF(ctx, pid));
+            }
+            if (policy->on_ready != NULL && policy->on_ready(ctx, PCB_OF(ctx, pid)) != 0)
+            {
+                return -1;
             }
         }
     }
-    return 0; // No active processes
+
+    ctx->policy = policy;
+    return 0;
 }
 
-// Move blocked process to ready state
-void scissos_unblock_process(void)
+// count ready processes
+int scissos_count_ready_processes(ScisSosContext *ctx)
+{
+    return ctx->ready_count;
+}
+
+// check for active processes
+int scisos_active_processes(ScisSosContext *ctx)
 {
-    for (int i = 0; i < MAXPROC; i++)
+    return ctx->active_count;
+}
+
+// Move processes whose I/O has completed back to the ready state; -1 if one could not be queued
+int scissos_unblock_process(ScisSosContext *ctx)
+{
+    int pid;
+
+    while ((pid = scissos_event_pop_due(ctx)) != EMPTY)
     {
-        if (_blockQ[i] != EMPTY)
-        {
-            int pid = _blockQ[i];
+        // the process may have been deleted while it was blocked
+        ScisSosPCB *pcb = scissos_pcb_lookup(ctx, pid);
 
-            // Add bounds check
-            if (pid < 1 || pid > MAXPROC)
+        if (pcb != NULL && pcb->ps_state == PS_BLK)
+        {
+            if (scissos_set_state(ctx, pcb, PS_RDY) != 0)
             {
-                fprintf(stderr, "Warning: Invalid PID %d in block queue\n", pid);
-                continue;
+                return -1;
             }
+            SCISSOS_LOG(ctx, LOG_DECISIONS, "[UNBLOCKED] Process PID %d moved to READY state\n", pcb->pid);
+        }
+    }
+    return 0;
+}
 
-            ScisSosPCB *pcb = _proctable[pid - 1];
+// Nothing is ready: jump the clock to the next I/O completion instead of spinning
+static int scissos_fast_forward(ScisSosContext *ctx)
+{
+    ScisSosTime next = scissos_event_next_time(ctx);
 
-            if (pcb != NULL && pcb->ps_state == PS_BLK)
+    if (next == NO_TIME)
+    {
+        // blocked without a pending completion; release them rather than deadlock
+        while (ctx->blockQ.head != EMPTY)
+        {
+            if (scissos_set_state(ctx, PCB_OF(ctx, ctx->blockQ.head), PS_RDY) != 0)
             {
-                pcb->ps_state = PS_RDY;
-                fprintf(stdout, "[UNBLOCKED] Process PID %d moved to READY state\n", pcb->pid);
+                return -1;
             }
         }
+        return 0;
     }
+
+    if (next > ctx->clock)
+    {
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[IDLE] CPU idle for %llu ticks until t=%llu\n", next - ctx->clock, next);
+        ctx->idle_ticks += next - ctx->clock;
+        ctx->cpus[0].idle_ticks += next - ctx->clock;
+        ctx->clock = next;
+    }
+
+    return scissos_unblock_process(ctx);
 }
 
-// Call the scheduler to manage processes
-void scissos_call_scheduler(char *scheduler)
+// Call the scheduler to dispatch one process for a single time slice. Single-CPU only:
+// everything runs on CPU 0, and several CPUs are stepped by scissos_run_smp instead.
+int scissos_call_scheduler(ScisSosContext *ctx)
 {
-    fprintf(stdout, "\n=== SCHEDULER INVOKED ===\n");
+    SCISSOS_LOG(ctx, LOG_TRACE, "\n=== SCHEDULER INVOKED ===\n");
 
-    // unblock processes
-    scissos_unblock_process();
+    if (ctx->policy == NULL)
+    {
+        fprintf(stderr, "Error: No scheduler selected\n");
+        return EMPTY;
+    }
 
-    // update ready queue and block queue
-    scisos_update_queues();
+    // a single CPU: everything runs on CPU 0
+    ScisSosCpu *cpu = &ctx->cpus[0];
+    ctx->rq = &cpu->rq;
+
+    // unblock processes whose I/O has completed, skipping idle time if none are ready
+    if (scissos_unblock_process(ctx) != 0 ||
+        (ctx->rq->readyQ.count == 0 && ctx->blockQ.count > 0 && scissos_fast_forward(ctx) != 0))
+    {
+        return EMPTY;
+    }
 
-    int ready_count = scissos_count_ready_processes();
+    int ready_count = scissos_count_ready_processes(ctx);
 
-    fprintf(stdout, "Number of ready processes: %d\n", ready_count);
+    SCISSOS_LOG(ctx, LOG_TRACE, "Number of ready processes: %d\n", ready_count);
 
     // Print Ready queue
-    if (ready_count > 0)
+    if (ready_count > 0 && SCISSOS_LOG_ON(ctx, LOG_TRACE))
     {
-        fprintf(stdout, "Ready Queue: [");
+        fprintf(ctx->log_out, "Ready Queue: [");
 
-        int first = 1;
-        for (int i = 0; i < MAXPROC && _readyQ[i] != EMPTY; i++)
+        for (int pid = ctx->rq->readyQ.head; pid != EMPTY; pid = PCB_OF(ctx, pid)->q_next)
         {
-            if (!first)
+            if (pid != ctx->rq->readyQ.head)
             {
-                fprintf(stdout, ", ");
+                fprintf(ctx->log_out, ", ");
             }
-            fprintf(stdout, "%d", _readyQ[i]);
-            first = 0;
+            fprintf(ctx->log_out, "%d", pid);
         }
-        fprintf(stdout, "]\n");
+        fprintf(ctx->log_out, "]\n");
     }
 
     // check for active processes
-    if (!scisos_active_processes())
+    if (!scisos_active_processes(ctx))
     {
-        fprintf(stdout, "No active processes --- Scheduler terminating\n");
-        fprintf(stdout, "=== SCHEDULER TERMINATED ===\n");
-        return;
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "No active processes --- Scheduler terminating\n");
+        SCISSOS_LOG(ctx, LOG_TRACE, "=== SCHEDULER TERMINATED ===\n");
+        return EMPTY;
     }
 
     // // if no ready processes --> terminate
@@ -186,58 +845,465 @@ void scissos_call_scheduler(char *scheduler)
     // }
 
     // Change current running process to READY (if exists)
-    if (_currentPID != EMPTY && _currentPID > 0 && _currentPID <= MAXPROC)
+    if (cpu->current_pid != EMPTY)
     {
-        ScisSosPCB *current_pcb = _proctable[_currentPID - 1];
-        if (current_pcb != NULL && current_pcb->ps_state == PS_RUN)
+        ScisSosPCB *current_pcb = scissos_pcb_lookup(ctx, cpu->current_pid);
+        if (current_pcb != NULL && current_pcb->ps_state == PS_RUN &&
+            scissos_set_state(ctx, current_pcb, PS_RDY) != 0)
         {
-            current_pcb->ps_state = PS_RDY;
+            return EMPTY;
         }
     }
 
     // call scheduling_algo
-    int selected_pid = EMPTY;
-    if (strcmp(scheduler, "fcfs") == 0)
+    int selected_pid = ctx->policy->pick(ctx);
+
+    // check for valid selected_pid
+    ScisSosPCB *pcb = scissos_pcb_lookup(ctx, selected_pid);
+    if (pcb == NULL)
     {
-        selected_pid = scissos_schedule_fcfs(_readyQ, ready_count);
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "Invalid process with PID %d selected for scheduling\n", selected_pid);
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "Scheduler terminating\n");
+        SCISSOS_LOG(ctx, LOG_TRACE, "=== SCHEDULER TERMINATED ===\n");
+        return EMPTY;
     }
-    else if (strcmp(scheduler, "sjf") == 0)
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "\n[SCHEDULED] Process %d selected for execution\n", selected_pid);
+
+    // update process state to running (leaves the ready queue)
+    scissos_set_state(ctx, pcb, PS_RUN);
+    cpu->current_pid = selected_pid;
+    pcb->last_cpu = 0;
+
+    SCISSOS_LOG(ctx, LOG_TRACE, "=== SCHEDULER TERMINATED ===\n");
+
+    // Run the selected process; it returns here after its quantum or block
+    int start_pc = pcb->pc;
+    if (scissos_proc_run(ctx, selected_pid) != 0)
     {
-        selected_pid = scissos_schedule_sjf(_readyQ, ready_count);
+        return EMPTY;
     }
-    else if (strcmp(scheduler, "rr") == 0)
+    cpu->dispatches++;
+    cpu->busy_ticks += pcb->pc - start_pc;
+
+    // A preempted process keeps its place at the head of the queue,
+    // except under round robin where it goes to the back
+    if (pcb->ps_state == PS_RDY && !ctx->policy->requeue_tail)
     {
-        selected_pid = scissos_schedule_rr(_readyQ, ready_count);
+        scissos_queue_remove(ctx, &ctx->rq->readyQ, pcb);
+        scissos_queue_push_front(ctx, &ctx->rq->readyQ, pcb);
     }
-    else if (strcmp(scheduler, "priority") == 0)
+
+    // Short-lived processes give their table slot back straight away
+    if (pcb->ps_state == PS_DEAD && ctx->reap_dead)
     {
-        selected_pid = scissos_schedule_priority(_readyQ, ready_count);
+        scissos_proc_delete(ctx, selected_pid);
     }
-    else
+
+    return selected_pid;
+}
+
+// Pull one ready process that may run on an idle CPU from the busiest other run queue,
+// looking at the most recently queued first; returns 1 if one was moved, -1 if it could
+// not be queued
+static int scissos_steal(ScisSosContext *ctx, int cpu)
+{
+    unsigned long long tried = 1ULL << cpu;
+
+    for (;;)
     {
-        fprintf(stderr, "Error: Unknown scheduler '%s'\n", scheduler);
-        fprintf(stdout, "Available schedulers: fcfs, sjf, priority, rr\n");
-        fprintf(stdout, "=== SCHEDULER TERMINATED ===\n");
-        return;
+        int victim = EMPTY;
+        for (int c = 0; c < ctx->ncpu; c++)
+        {
+            int count = ctx->cpus[c].rq.readyQ.count;
+            if (!(tried >> c & 1) && count > 0 && (victim == EMPTY || count > ctx->cpus[victim].rq.readyQ.count))
+            {
+                victim = c;
+            }
+        }
+        if (victim == EMPTY)
+        {
+            return 0;
+        }
+        tried |= 1ULL << victim;
+
+        int scanned = 0;
+        for (int pid = ctx->cpus[victim].rq.readyQ.tail; pid != EMPTY && scanned < STEAL_SCAN; scanned++)
+        {
+            ScisSosPCB *pcb = PCB_OF(ctx, pid);
+            if (scissos_allowed_cpus(ctx, pcb) >> cpu & 1)
+            {
+                SCISSOS_LOG(ctx, LOG_DECISIONS, "[STEAL] CPU %d took process %d from CPU %d\n", cpu, pid, victim);
+                ctx->cpus[cpu].steals++;
+                return scissos_migrate(ctx, pcb, cpu) == 0 ? 1 : -1;
+            }
+            pid = pcb->q_prev;
+        }
     }
+}
 
-    // check for valid selected_pid
-    if (selected_pid <= 0 || selected_pid > MAXPROC || _proctable[selected_pid - 1] == NULL)
+// Even out the run queues: repeatedly move processes from the most to the least loaded CPU
+// until no two CPUs differ by more than one process or nothing movable is left; -1 if a
+// moved process could not be queued
+static int scissos_balance(ScisSosContext *ctx)
+{
+    for (int pass = 0; pass < ctx->ncpu; pass++)
     {
-        fprintf(stdout, "Invalid process with PID %d selected for scheduling\n", selected_pid);
-        fprintf(stdout, "Scheduler terminating\n");
-        fprintf(stdout, "=== SCHEDULER TERMINATED ===\n");
-        return;
+        int busiest = 0, idlest = 0;
+        for (int c = 1; c < ctx->ncpu; c++)
+        {
+            if (scissos_cpu_load(ctx, c) > scissos_cpu_load(ctx, busiest))
+            {
+                busiest = c;
+            }
+            if (scissos_cpu_load(ctx, c) < scissos_cpu_load(ctx, idlest))
+            {
+                idlest = c;
+            }
+        }
+
+        int excess = (scissos_cpu_load(ctx, busiest) - scissos_cpu_load(ctx, idlest)) / 2;
+        int moved = 0;
+        int pid = ctx->cpus[busiest].rq.readyQ.tail;
+        while (pid != EMPTY && moved < excess)
+        {
+            ScisSosPCB *pcb = PCB_OF(ctx, pid);
+            pid = pcb->q_prev;
+            if (scissos_allowed_cpus(ctx, pcb) >> idlest & 1)
+            {
+                if (scissos_migrate(ctx, pcb, idlest) != 0)
+                {
+                    return -1;
+                }
+                ctx->cpus[idlest].balanced++;
+                moved++;
+            }
+        }
+
+        if (moved == 0)
+        {
+            break;
+        }
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[BALANCE] Moved %d processes from CPU %d to CPU %d\n", moved, busiest, idlest);
     }
+    return 0;
+}
 
-    fprintf(stdout, "\n[SCHEDULED] Process %d selected for execution\n", selected_pid);
+// Run one dispatched CPU's quantum: advance the process to where it ends
+static void scissos_cpu_execute(ScisSosContext *ctx, int c)
+{
+    ScisSosCpu *cpu = &ctx->cpus[c];
+    ScisSosPCB *pcb = PCB_OF(ctx, cpu->current_pid);
+    int start_pc = pcb->pc;
 
-    // update process state to running
-    _proctable[selected_pid - 1]->ps_state = PS_RUN;
-    _currentPID = selected_pid;
+    cpu->burst_state = scissos_proc_start(ctx, pcb);
+    cpu->burst_ticks = pcb->pc - start_pc;
+}
 
-    fprintf(stdout, "=== SCHEDULER TERMINATED ===\n");
+// Order two running CPUs by the end of their quanta, then by number
+static int scissos_busy_less(ScisSosContext *ctx, int a, int b)
+{
+    return ctx->cpus[a].free_at < ctx->cpus[b].free_at ||
+           (ctx->cpus[a].free_at == ctx->cpus[b].free_at && a < b);
+}
 
-    // Run the selected process
-    scissos_proc_run(selected_pid, scheduler);
-}
\ No newline at end of file
+// Add a CPU whose quantum has started to the running set
+static void scissos_busy_push(ScisSosContext *ctx, int c)
+{
+    int *heap = ctx->busy_heap;
+    int i = ctx->busy_count++;
+
+    while (i > 0 && scissos_busy_less(ctx, c, heap[(i - 1) / 2]))
+    {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = c;
+}
+
+// Remove and return the running CPU whose quantum ends first
+static int scissos_busy_pop(ScisSosContext *ctx)
+{
+    int *heap = ctx->busy_heap;
+    int top = heap[0];
+    int last = heap[--ctx->busy_count];
+    int i = 0;
+
+    for (;;)
+    {
+        int child = 2 * i + 1;
+        if (child >= ctx->busy_count)
+        {
+            break;
+        }
+        if (child + 1 < ctx->busy_count && scissos_busy_less(ctx, heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if (!scissos_busy_less(ctx, heap[child], last))
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+
+    return top;
+}
+
+// Pick the next process for an idle CPU, stealing work if its own queue is empty, and make
+// it running; its quantum is executed separately. Returns the PID, EMPTY if there is
+// nothing the CPU may run, or -1 if a stolen process could not be queued.
+static int scissos_cpu_dispatch(ScisSosContext *ctx, int c)
+{
+    ScisSosCpu *cpu = &ctx->cpus[c];
+
+    if (cpu->rq.readyQ.count == 0)
+    {
+        int stolen = scissos_steal(ctx, c);
+        if (stolen <= 0)
+        {
+            return stolen < 0 ? -1 : EMPTY;
+        }
+    }
+
+    ctx->rq = &cpu->rq;
+    int selected_pid = ctx->policy->pick(ctx);
+    ScisSosPCB *pcb = scissos_pcb_lookup(ctx, selected_pid);
+    if (pcb == NULL)
+    {
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "Invalid process with PID %d selected for scheduling on CPU %d\n", selected_pid, c);
+        return EMPTY;
+    }
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "\n[SCHEDULED] Process %d selected for execution on CPU %d\n", selected_pid, c);
+    scissos_set_state(ctx, pcb, PS_RUN);
+
+    // a process whose cache state is on another CPU costs a warm-up first
+    ScisSosTime cost = 0;
+    if (pcb->last_cpu != EMPTY && pcb->last_cpu != c)
+    {
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[MIGRATED] Process %d from CPU %d to CPU %d\n", selected_pid, pcb->last_cpu, c);
+        cost = ctx->migration_cost;
+        cpu->migrations++;
+    }
+    pcb->last_cpu = c;
+
+    cpu->idle_ticks += ctx->clock - cpu->idle_since;
+    ctx->idle_ticks += ctx->clock - cpu->idle_since;
+    ctx->idle_cpus &= ~(1ULL << c);
+    cpu->current_pid = selected_pid;
+    cpu->free_at = ctx->clock + cost; // the quantum itself is added once it has run
+    cpu->dispatches++;
+    cpu->overhead_ticks += cost;
+
+    return selected_pid;
+}
+
+// End the quantum running on a CPU; the clock has reached its end. -1 if the process could
+// not be queued again.
+static int scissos_cpu_finish(ScisSosContext *ctx, int c)
+{
+    ScisSosCpu *cpu = &ctx->cpus[c];
+    ScisSosPCB *pcb = PCB_OF(ctx, cpu->current_pid);
+
+    cpu->current_pid = EMPTY;
+    cpu->idle_since = ctx->clock;
+    ctx->idle_cpus |= 1ULL << c;
+    ctx->rq = &cpu->rq;
+    if (scissos_proc_finish(ctx, pcb, cpu->burst_ticks, cpu->burst_state) != 0)
+    {
+        return -1;
+    }
+
+    // a real-time process whose next job is already released goes back in line
+    if (pcb->ps_state == PS_RUN && scissos_set_state(ctx, pcb, PS_RDY) != 0)
+    {
+        return -1;
+    }
+
+    if (pcb->ps_state == PS_RDY && !ctx->policy->requeue_tail)
+    {
+        scissos_queue_remove(ctx, &ctx->rq->readyQ, pcb);
+        scissos_queue_push_front(ctx, &ctx->rq->readyQ, pcb);
+    }
+
+    if (pcb->ps_state == PS_DEAD && ctx->reap_dead)
+    {
+        scissos_proc_delete(ctx, pcb->pid);
+    }
+    return 0;
+}
+
+// Dispatch on several CPUs until no processes are active. The clock jumps to the earliest
+// quantum end (or I/O completion while a CPU is idle) and quanta are started and finished
+// in clock order, so no CPU sees another's future. Each step costs O(log CPUs) plus the
+// CPUs dispatched, however many there are. Returns the dispatches, or -1 if a process
+// could not be queued.
+static long scissos_run_smp(ScisSosContext *ctx)
+{
+    long dispatches = 0;
+    int failed = 0;
+    int batch[MAXCPUS];
+
+    if (ctx->policy == NULL)
+    {
+        fprintf(stderr, "Error: No scheduler selected\n");
+        return -1;
+    }
+
+    // every CPU starts idle
+    ctx->idle_cpus = ctx->ncpu < 64 ? (1ULL << ctx->ncpu) - 1 : ~0ULL;
+    ctx->busy_count = 0;
+    for (int c = 0; c < ctx->ncpu; c++)
+    {
+        ctx->cpus[c].idle_since = ctx->clock;
+    }
+
+    while (!failed && scisos_active_processes(ctx))
+    {
+        if (scissos_unblock_process(ctx) != 0)
+        {
+            failed = 1;
+            break;
+        }
+
+        if (ctx->clock >= ctx->next_balance)
+        {
+            failed = scissos_balance(ctx) != 0;
+            ctx->next_balance = ctx->clock + ctx->balance_period;
+        }
+
+        // idle CPUs take the next process from their own queue or a busier one
+        int count = 0;
+        for (unsigned long long idle = ctx->idle_cpus; !failed && idle != 0 && ctx->ready_count > 0; idle &= idle - 1)
+        {
+            int c = __builtin_ctzll(idle);
+            int pid = scissos_cpu_dispatch(ctx, c);
+            if (pid == -1)
+            {
+                failed = 1;
+            }
+            else if (pid != EMPTY)
+            {
+                batch[count++] = c;
+            }
+        }
+
+        // run what was just dispatched, then queue the CPUs by the end of their quanta
+        for (int i = 0; i < count; i++)
+        {
+            ScisSosCpu *cpu = &ctx->cpus[batch[i]];
+            scissos_cpu_execute(ctx, batch[i]);
+            cpu->free_at += cpu->burst_ticks;
+            cpu->busy_ticks += cpu->burst_ticks;
+            scissos_busy_push(ctx, batch[i]);
+        }
+        dispatches += count;
+
+        // the next moment anything happens
+        ScisSosTime next = ctx->busy_count > 0 ? ctx->cpus[ctx->busy_heap[0]].free_at : NO_TIME;
+        if (ctx->idle_cpus != 0)
+        {
+            ScisSosTime io = scissos_event_next_time(ctx);
+            if (io != NO_TIME && io < next)
+            {
+                next = io;
+            }
+        }
+
+        if (next == NO_TIME)
+        {
+            if (ctx->blockQ.count == 0)
+            {
+                break; // nothing runs, waits or can be dispatched
+            }
+            // blocked without a pending completion; release them rather than deadlock
+            while (!failed && ctx->blockQ.head != EMPTY)
+            {
+                failed = scissos_set_state(ctx, PCB_OF(ctx, ctx->blockQ.head), PS_RDY) != 0;
+            }
+            continue;
+        }
+
+        if (next > ctx->clock)
+        {
+            if (ctx->busy_count == 0)
+            {
+                SCISSOS_LOG(ctx, LOG_DECISIONS, "[IDLE] All CPUs idle for %llu ticks until t=%llu\n", next - ctx->clock, next);
+            }
+            ctx->clock = next;
+        }
+
+        while (!failed && ctx->busy_count > 0 && ctx->cpus[ctx->busy_heap[0]].free_at <= ctx->clock)
+        {
+            failed = scissos_cpu_finish(ctx, scissos_busy_pop(ctx)) != 0;
+        }
+    }
+
+    // close the idle periods still open
+    for (int c = 0; c < ctx->ncpu; c++)
+    {
+        if (ctx->cpus[c].current_pid == EMPTY)
+        {
+            ctx->cpus[c].idle_ticks += ctx->clock - ctx->cpus[c].idle_since;
+            ctx->idle_ticks += ctx->clock - ctx->cpus[c].idle_since;
+            ctx->cpus[c].idle_since = ctx->clock;
+        }
+    }
+
+    return failed ? -1 : dispatches;
+}
+
+// Dispatch processes iteratively until none are active. Returns the dispatches, or -1 if
+// scheduling stopped with work left, e.g. because a policy could not queue a process.
+long scissos_run_dispatcher(ScisSosContext *ctx)
+{
+    long dispatches = 0;
+
+    if (ctx->ncpu > 1)
+    {
+        dispatches = scissos_run_smp(ctx);
+    }
+    else
+    {
+        while (scisos_active_processes(ctx))
+        {
+            SCISSOS_LOG(ctx, LOG_TRACE, "\n--- Scheduling Iteration %ld ---\n", dispatches + 1);
+
+            if (scissos_call_scheduler(ctx) == EMPTY)
+            {
+                break;
+            }
+            dispatches++;
+        }
+    }
+
+    if (dispatches < 0 || scisos_active_processes(ctx))
+    {
+        fprintf(stderr, "Error: Scheduling stopped with %d processes still active\n", ctx->active_count);
+        return -1;
+    }
+    return dispatches;
+}
+
+// Delete every remaining process and release the instruction arena in bulk
+void scissos_shutdown(ScisSosContext *ctx)
+{
+    for (int i = 0; i < ctx->proc_capacity; i++)
+    {
+        if (ctx->proctable[i] != NULL)
+        {
+            scissos_proc_delete(ctx, ctx->proctable[i]->pid);
+        }
+    }
+
+    scissos_arena_destroy(ctx);
+    scissos_workload_unmap(ctx);
+    scissos_event_reset(ctx);
+    for (int c = 0; c < ctx->ncpu; c++)
+    {
+        ctx->cpus[c].current_pid = EMPTY;
+    }
+}
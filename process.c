@@ -1,23 +1,127 @@
 #include "ScisSos.h"
+#include "scheduling_algo.h"
 
-static int pid_counter = 1; // Global PID counter
-
-// Generate code for a process based on its type
-ScisSosInst **scissos_generate_code(int size, int p_type)
+// Allocate an empty packed code stream of the given size in the arena. With lazy code
+// enabled, large streams only get room for one CODE_CHUNK window of instructions.
+ScisSosCode *scissos_code_alloc(ScisSosContext *ctx, int size)
 {
-    if (size <= 0)
+    int lazy = ctx->lazy_code && size > CODE_CHUNK;
+    int held = lazy ? CODE_CHUNK : size;
+    int words = CODE_WORDS(held);
+
+    // header, bitmap, skip index and addresses share one arena block
+    size_t bytes = sizeof(ScisSosCode) +
+                   (size_t)words * sizeof(unsigned long long) +
+                   (size_t)(words + 1) * sizeof(int) +
+                   (size_t)held * sizeof(unsigned short);
+
+    ScisSosCode *code = (ScisSosCode *)scissos_arena_alloc(ctx, bytes);
+    if (!code)
     {
-        fprintf(stderr, "Error: Invalid size %d for code generation.\n", size);
         return NULL;
     }
 
-    ScisSosInst **code = (ScisSosInst **)malloc(size * sizeof(ScisSosInst *));
-    if (!code)
+    code->size = size;
+    code->base = 0;
+    code->limit = 0;
+    code->lazy = lazy;
+    code->lng = (unsigned long long *)(code + 1);
+    code->skip = (int *)(code->lng + words);
+    code->addref = (unsigned short *)(code->skip + words + 1);
+
+    return code;
+}
+
+// Build the skip index once the long-syscall bitmap of the window is filled in
+void scissos_code_index(ScisSosCode *code)
+{
+    int words = CODE_WORDS(code->limit - code->base);
+
+    code->skip[words] = code->limit;
+    for (int w = words - 1; w >= 0; w--)
     {
-        fprintf(stderr, "Error: Memory allocation failed for process code.\n");
-        return NULL;
+        if (code->lng[w])
+        {
+            code->skip[w] = code->base + w * 64 + __builtin_ctzll(code->lng[w]);
+        }
+        else
+        {
+            code->skip[w] = code->skip[w + 1];
+        }
     }
+}
 
+// Position of the first long syscall at or after pc in the window, code->limit if none
+int scissos_code_next_long(const ScisSosCode *code, int pc)
+{
+    if (pc >= code->limit)
+    {
+        return code->limit;
+    }
+
+    // Check the rest of the current word, then jump straight through the index
+    int rel = pc - code->base;
+    int w = rel >> 6;
+    unsigned long long bits = code->lng[w] & (~0ULL << (rel & 63));
+    if (bits)
+    {
+        return code->base + w * 64 + __builtin_ctzll(bits);
+    }
+
+    return code->skip[w + 1];
+}
+
+// Decode a single instruction; it must lie in the current window
+void scissos_code_fetch(const ScisSosCode *code, int i, ScisSosInst *inst)
+{
+    int rel = i - code->base;
+
+    inst->_inum = i;
+    inst->_syscall = (code->lng[rel >> 6] >> (rel & 63)) & 1 ? INS_LNG : INS_SHR;
+    inst->_addref = code->addref[rel];
+}
+
+// Generate the next window of instructions from the stream's generator state
+static void scissos_code_generate(ScisSosCode *code)
+{
+    int base = code->limit;
+    int count = code->lazy && code->size - base > CODE_CHUNK ? CODE_CHUNK : code->size - base;
+
+    memset(code->lng, 0, (size_t)CODE_WORDS(count) * sizeof(unsigned long long));
+
+    // One draw per instruction: the high half decides long or short, the low half the address
+    for (int i = 0; i < count; i++)
+    {
+        unsigned long long r = scissos_rng_next(&code->rng);
+
+        // Determine if this is a long or short system call
+        if ((r >> 32) < code->long_thr)
+        {
+            code->lng[i >> 6] |= 1ULL << (i & 63);
+        }
+
+        // Generate random memory address reference in [0, 1000)
+        code->addref[i] = (unsigned short)(((r & 0xFFFFFFFFULL) * 1000) >> 32);
+    }
+
+    code->base = base;
+    code->limit = base + count;
+    scissos_code_index(code);
+}
+
+// Make pc part of the window, generating (and recycling the arrays of) the chunks before it
+void scissos_code_seek(ScisSosCode *code, int pc)
+{
+    while (pc >= code->limit && code->limit < code->size)
+    {
+        scissos_code_generate(code);
+    }
+}
+
+// Fill an allocated code stream for a process of the given type from the process's own
+// stream; lazy code keeps the generator and produces only its first window now
+void scissos_code_fill(ScisSosCode *code, ScisSosRng *rng, int p_type)
+{
     double long_call_prob;
     switch (p_type)
     {
@@ -32,44 +136,121 @@ ScisSosInst **scissos_generate_code(int size, int p_type)
         break;
     }
 
-    for (int i = 0; i < size; i++)
+    code->long_thr = (unsigned long long)(long_call_prob * 4294967296.0);
+    code->rng = *rng;
+    code->base = 0;
+    code->limit = 0;
+    scissos_code_generate(code);
+}
+
+// First long syscall in [pc, end), end if none; lazy code is generated as the scan advances
+int scissos_code_scan_long(ScisSosCode *code, int pc, int end)
+{
+    for (;;)
     {
-        code[i] = (ScisSosInst *)malloc(sizeof(ScisSosInst));
-        if (!code[i])
+        scissos_code_seek(code, pc);
+
+        int next_long = scissos_code_next_long(code, pc);
+        if (next_long < code->limit || code->limit >= end)
         {
-            fprintf(stderr, "Error: Memory allocation failed for instruction %d.\n", i);
-            // Free previously allocated instructions
-            for (int j = 0; j < i; j++)
-            {
-                free(code[j]);
-            }
-            free(code);
-            return NULL;
+            return next_long < end ? next_long : end;
         }
 
-        code[i]->_inum = i;
+        // No long syscall left in this window; continue in the next one
+        pc = code->limit;
+    }
+}
 
-        // Determine if this is a long or short system call
-        double rand_val = (double)rand() / RAND_MAX;
-        if (rand_val < long_call_prob)
-        {
-            code[i]->_syscall = INS_LNG;
-        }
-        else
-        {
-            code[i]->_syscall = INS_SHR;
-        }
+// Generate code for a process based on its type, drawing from the process's own stream
+ScisSosCode *scissos_generate_code(ScisSosContext *ctx, ScisSosRng *rng, int size, int p_type)
+{
+    if (size <= 0)
+    {
+        fprintf(stderr, "Error: Invalid size %d for code generation.\n", size);
+        return NULL;
+    }
 
-        // Generate random memory address reference
-        code[i]->_addref = rand() % 1000;
+    ScisSosCode *code = scissos_code_alloc(ctx, size);
+    if (!code)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for process code.\n");
+        return NULL;
     }
 
+    scissos_code_fill(code, rng, p_type);
+
     return code;
 }
 
+// Initialise a PCB; reads but never writes the context, so workers may call it concurrently
+void scissos_pcb_init(ScisSosContext *ctx, ScisSosPCB *pcb, int pid, int uid, int size,
+                      int priority, int p_type, ScisSosCode *code)
+{
+    pcb->pid = pid;
+    pcb->uid = uid;
+    pcb->size = size;
+    pcb->priority_value = priority;
+    pcb->ps_state = PS_NEW; // Initial state is New
+    pcb->p_type = p_type;
+    pcb->m_type = MT_GOOD;
+    pcb->pc = 0; // Program counter starts at 0
+    pcb->p_code = code;
+    pcb->p_timeslice = ctx->timeslice; // Initial time slice
+    pcb->q_next = EMPTY;
+    pcb->q_prev = EMPTY;
+    pcb->heap_pos = EMPTY;
+    pcb->level = 0;
+    pcb->level_epoch = ctx->mlfq_epoch;
+    pcb->l_next = EMPTY;
+    pcb->l_prev = EMPTY;
+    pcb->vruntime = 0;
+    pcb->weight = 0;
+    pcb->period = 0;
+    pcb->rel_deadline = 0;
+    pcb->wcet = 0;
+    pcb->job_done = 0;
+    pcb->t_release = 0;
+    pcb->t_deadline = NO_TIME;
+    pcb->tickets = scissos_priority_weight(priority);
+    pcb->lottery_tickets = pcb->tickets;
+    pcb->pass = 0;
+    pcb->share_mark = 0;
+    pcb->entitled = 0;
+    pcb->cpu = 0;
+    pcb->last_cpu = EMPTY;
+    pcb->vr_cpu = 0;
+    pcb->affinity = ~0ULL;
+    if (ctx->affinity_width > 0 && ctx->affinity_width < ctx->ncpu)
+    {
+        // a window of consecutive CPUs, spread round the machine by table slot
+        pcb->affinity = 0;
+        for (int i = 0; i < ctx->affinity_width; i++)
+        {
+            pcb->affinity |= 1ULL << ((PID_SLOT(pid) + i) % ctx->ncpu);
+        }
+    }
+    pcb->burst_avg = 0;
+    pcb->burst_run = 0;
+    pcb->quanta = 0;
+    pcb->preemptions = 0;
+    pcb->t_arrival = ctx->clock;
+    pcb->t_first_run = NO_TIME;
+    pcb->t_completion = NO_TIME;
+    pcb->t_ready = 0;
+    pcb->t_blocked = 0;
+    pcb->t_last = ctx->clock;
+
+    // Page table initialisation
+    for (int i = 0; i < MAXPGES; i++)
+    {
+        pcb->pg_table[i][0] = i;
+        pcb->pg_table[i][1] = EMPTY;
+    }
+}
+
 // Create and initialise a PCB
-void scissos_create_pcb(ScisSosProcess *process, int pid, int uid, int size,
-                        int priority, int p_type, ScisSosInst **code)
+void scissos_create_pcb(ScisSosContext *ctx, ScisSosProcess *process, int pid, int uid, int size,
+                        int priority, int p_type, ScisSosCode *code)
 {
     process->_pcb = (ScisSosPCB *)malloc(sizeof(ScisSosPCB));
     if (!process->_pcb)
@@ -78,27 +259,21 @@ void scissos_create_pcb(ScisSosProcess *process, int pid, int uid, int size,
         return;
     }
 
-    process->_pcb->pid = pid;
-    process->_pcb->uid = uid;
-    process->_pcb->size = size;
-    process->_pcb->priority_value = priority;
-    process->_pcb->ps_state = PS_NEW; // Initial state is New
-    process->_pcb->p_type = p_type;
-    process->_pcb->m_type = MT_GOOD;
-    process->_pcb->pc = 0; // Program counter starts at 0
-    process->_pcb->p_code = code;
-    process->_pcb->p_timeslice = DEFTS; // Initial time slice
+    scissos_pcb_init(ctx, process->_pcb, pid, uid, size, priority, p_type, code);
+}
 
-    // Page table initialisation
-    for (int i = 0; i < MAXPGES; i++)
-    {
-        process->_pcb->pg_table[i][0] = i;
-        process->_pcb->pg_table[i][1] = EMPTY;
-    }
+// Enter an initialised PCB in the process table under its reserved PID and make it ready;
+// -1 if the policy could not queue it, in which case it stays in the table to be deleted
+int scissos_proc_register(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    PCB_OF(ctx, pcb->pid) = pcb;
+
+    // set process state to ready (joins the ready queue)
+    return scissos_set_state(ctx, pcb, PS_RDY);
 }
 
 // Create a new process and return its pointer
-ScisSosProcess *scissos_proc_create(char *process_name, int size, int priority, int p_type)
+ScisSosProcess *scissos_proc_create(ScisSosContext *ctx, char *process_name, int size, int priority, int p_type)
 {
     // Check size validity
     if (size <= 0)
@@ -107,21 +282,26 @@ ScisSosProcess *scissos_proc_create(char *process_name, int size, int priority,
         return NULL;
     }
 
-    // Check if we have space in process table
-    if (pid_counter > MAXPROC)
+    // Reserve a slot in the process table (reusing a freed one if possible)
+    int pid = scissos_pid_alloc(ctx);
+    if (pid == EMPTY)
     {
         fprintf(stderr, "Error: Process table full. Cannot create more processes.\n");
         return NULL;
     }
 
-    int pid = pid_counter++;
-    int uid = rand() % MAXUSRS + 1; // Random UID between 1 and MAXUSRS
+    // Everything random about the process comes from its own stream of the master seed
+    ScisSosRng rng;
+    scissos_rng_seed(&rng, ctx->seed, (unsigned long long)pid);
+
+    int uid = scissos_rng_below(&rng, MAXUSRS) + 1; // Random UID between 1 and MAXUSRS
 
     // Generate code for process
-    ScisSosInst **code = scissos_generate_code(size, p_type);
+    ScisSosCode *code = scissos_generate_code(ctx, &rng, size, p_type);
     if (!code)
     {
         fprintf(stderr, "Error: Failed to generate code for process.\n");
+        scissos_pid_release(ctx, pid);
         return NULL;
     }
 
@@ -130,12 +310,8 @@ ScisSosProcess *scissos_proc_create(char *process_name, int size, int priority,
     if (!new_process)
     {
         fprintf(stderr, "Error: Memory allocation failed for process structure.\n");
-        // Free the code
-        for (int i = 0; i < size; i++)
-        {
-            free(code[i]);
-        }
-        free(code);
+        scissos_arena_release(ctx, code);
+        scissos_pid_release(ctx, pid);
         return NULL;
     }
 
@@ -145,16 +321,26 @@ ScisSosProcess *scissos_proc_create(char *process_name, int size, int priority,
     new_process->_CODE = code;
 
     // PCB creation and initialisation
-    scissos_create_pcb(new_process, pid, uid, size, priority, p_type, new_process->_CODE);
-
-    // Add process to process table
-    _proctable[pid - 1] = new_process->_pcb;
+    scissos_create_pcb(ctx, new_process, pid, uid, size, priority, p_type, new_process->_CODE);
+    if (!new_process->_pcb)
+    {
+        scissos_arena_release(ctx, code);
+        scissos_pid_release(ctx, pid);
+        free(new_process);
+        return NULL;
+    }
 
-    // set process state to ready
-    new_process->_pcb->ps_state = PS_RDY;
+    // Add process to process table and the ready queue
+    if (scissos_proc_register(ctx, new_process->_pcb) != 0)
+    {
+        fprintf(stderr, "Error: Cannot queue process %s.\n", process_name);
+        scissos_proc_delete(ctx, pid);
+        free(new_process);
+        return NULL;
+    }
 
-    fprintf(stdout, "Process created: %s, PID: %d, UID: %d, Priority: %d, Type: %d\n",
-            process_name, pid, uid, priority, p_type);
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "Process created: %s, PID: %d, UID: %d, Priority: %d, Type: %d\n",
+                process_name, pid, uid, priority, p_type);
 
     return new_process;
 }
@@ -206,114 +392,278 @@ int scissos_proc_save(ScisSosProcess *process, FILE *process_info)
     return 0;
 }
 
-// run the process with the given PID
-int scissos_proc_run(int pid, char *scheduler)
+// Give back the CPU share reserved for a real-time process
+static void scissos_rt_release(ScisSosContext *ctx, ScisSosPCB *pcb)
 {
-    // Validate PID
-    if (pid < 1 || pid > MAXPROC)
+    if (pcb->period == 0)
     {
-        fprintf(stderr, "Error: Invalid PID %d.\n", pid);
-        return -1;
+        return;
     }
 
-    // get pcb from process table
-    ScisSosPCB *pcb = _proctable[pid - 1];
+    ctx->rt_count--;
+    ctx->rt_util -= (double)pcb->wcet / pcb->period;
+    ctx->rt_density -= (double)pcb->wcet / pcb->rel_deadline;
+    pcb->period = 0;
+}
 
-    if (pcb == NULL)
-    {
-        fprintf(stderr, "Error: Process with PID %d not found.\n", pid);
-        return -1;
-    }
+// Start one quantum of a running process: move its PC to where the quantum ends and return
+// the state it ends in. The instructions executed are the PC advance; the clock is left alone
+// so that SMP simulation can finish the quantum when the other CPUs have caught up.
+int scissos_proc_start(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    int pid = pcb->pid;
 
-    fprintf(stdout, "\n[RUNNING] Process PID %d starting from PC = %d\n", pid, pcb->pc);
+    SCISSOS_LOG(ctx, LOG_TRACE, "\n[RUNNING] Process PID %d starting from PC = %d\n", pid, pcb->pc);
 
-    int exec_instr = 0; /* Number of instructions executed */
     int start_pc = pcb->pc;
 
-    // Execute instructions
-    while (pcb->pc < pcb->size)
+    // The quantum ends at the time slice, the end of the code or the next long syscall
+    int end_pc = pcb->size - pcb->pc > pcb->p_timeslice ? pcb->pc + pcb->p_timeslice : pcb->size;
+    // A real-time job ends after wcet instructions; the process then waits for its next release
+    if (pcb->period > 0 && pcb->wcet - pcb->job_done < end_pc - pcb->pc)
     {
-        ScisSosInst *instr = pcb->p_code[pcb->pc];
+        end_pc = pcb->pc + pcb->wcet - pcb->job_done;
+    }
+    int next_long = scissos_code_scan_long(pcb->p_code, pcb->pc, end_pc);
 
+    int new_state = PS_RUN;
+
+    if (next_long < end_pc)
+    {
         // long system call -> block the process
-        if (instr->_syscall == INS_LNG)
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[BLOCKED] Process PID %d on instruction %d (Long Syscall)\n",
+                    pid, next_long);
+        pcb->pc = next_long + 1; // Move past the long syscall
+        new_state = PS_BLK;
+    }
+    else
+    {
+        // only short system calls until end_pc -> execute them in one step
+        pcb->pc = end_pc;
+
+        // time quantum exhaustion case
+        if (end_pc - start_pc >= pcb->p_timeslice)
         {
-            fprintf(stdout, "[BLOCKED] Process PID %d on instruction %d (Long Syscall)\n",
-                    pid, instr->_inum);
-            pcb->pc++; // Move to next instruction
-            pcb->ps_state = PS_BLK;
-            exec_instr++;
-            break;
+            SCISSOS_LOG(ctx, LOG_DECISIONS, "[TIME SLICE EXHAUSTED] Process PID %d after executing %d instructions\n",
+                        pid, end_pc - start_pc);
+            new_state = PS_RDY;
         }
+    }
 
-        // short system call -> continue execution
-        // fprintf(stdout, "[EXECUTING] Process PID %d executing instruction %d (Short Syscall)\n",
-        //         pid, instr->_inum);
-        pcb->pc++; // Move to next instruction
-        exec_instr++;
+    return new_state;
+}
 
-        // time quantum exhaustion case
-        if (exec_instr >= pcb->p_timeslice)
+// Finish a quantum of exec_instr instructions at the current clock: charge it, account
+// real-time jobs and move the process to the state the quantum ends in; -1 if it could not
+// be queued again
+int scissos_proc_finish(ScisSosContext *ctx, ScisSosPCB *pcb, int exec_instr, int new_state)
+{
+    int pid = pcb->pid;
+    int start_pc = pcb->pc - exec_instr;
+
+    // the CPU time just used is shared out over the tickets of every runnable process
+    if (ctx->share_tickets > 0)
+    {
+        ctx->share_pass += ((long long)exec_instr << SHARE_SHIFT) / ctx->share_tickets;
+    }
+
+    if (ctx->policy != NULL && ctx->policy->on_charge != NULL)
+    {
+        ctx->policy->on_charge(ctx, pcb, exec_instr);
+    }
+
+    // a finished real-time job is judged against its deadline and the next one is set up
+    int await_release = 0;
+    if (pcb->period > 0)
+    {
+        pcb->job_done += exec_instr;
+        if (pcb->job_done >= pcb->wcet || pcb->pc >= pcb->size)
         {
-            fprintf(stdout, "[TIME SLICE EXHAUSTED] Process PID %d after executing %d instructions\n",
-                    pid, exec_instr);
-            pcb->ps_state = PS_RDY;
-            break;
+            SCISSOS_LOG(ctx, LOG_DECISIONS, "[JOB DONE] Process PID %d job released at %llu done at %llu (deadline %llu)\n",
+                        pid, pcb->t_release, ctx->clock, pcb->t_deadline);
+            scissos_metrics_record_job(ctx, pcb);
+            pcb->job_done = 0;
+            pcb->t_release += pcb->period;
+            pcb->t_deadline = pcb->t_release + pcb->rel_deadline;
+            await_release = pcb->t_release > ctx->clock;
         }
     }
 
     // check for process completion
     if (pcb->pc >= pcb->size)
     {
-        fprintf(stdout, "[COMPLETED] Process PID %d completed\n", pid);
-        pcb->ps_state = PS_DEAD;
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[COMPLETED] Process PID %d completed\n", pid);
+        new_state = PS_DEAD;
+        scissos_rt_release(ctx, pcb);
+    }
+    else if (await_release)
+    {
+        // sleep until the next release; an overrunning job carries straight on
+        new_state = PS_BLK;
     }
 
-    fprintf(stdout, "[STATUS] Process PID %d moved from PC = %d to PC = %d, State = %d\n",
-            pid, start_pc, pcb->pc, pcb->ps_state);
+    // let the policy learn from how the quantum ended before the process is queued again
+    if (new_state == PS_RDY && ctx->policy != NULL && ctx->policy->on_expire != NULL)
+    {
+        ctx->policy->on_expire(ctx, pcb);
+    }
+    else if (new_state == PS_BLK && ctx->policy != NULL && ctx->policy->on_block != NULL)
+    {
+        ctx->policy->on_block(ctx, pcb);
+    }
+
+    // then the time-slice controller sizes its next quantum; MLFQ and CFS size their
+    // own when they pick it, so there it only counts the quantum
+    scissos_quantum_update(ctx, pcb, exec_instr, new_state);
+
+    if (scissos_set_state(ctx, pcb, new_state) != 0)
+    {
+        return -1;
+    }
 
-    // call scheduler recursively
-    scissos_call_scheduler(scheduler);
+    // the long syscall completes after a simulated I/O latency; a waiting real-time
+    // process wakes up at its next release instead
+    if (new_state == PS_BLK && await_release)
+    {
+        scissos_event_schedule_at(ctx, pcb, pcb->t_release);
+    }
+    else if (new_state == PS_BLK)
+    {
+        scissos_event_schedule_io(ctx, pcb);
+    }
 
+    SCISSOS_LOG(ctx, LOG_TRACE, "[STATUS] Process PID %d moved from PC = %d to PC = %d, State = %d\n",
+                pid, start_pc, pcb->pc, pcb->ps_state);
     return 0;
 }
 
-// Delete the process with the given PID
-void scissos_proc_delete(int pid)
+// run the process with the given PID for one time slice (or until it blocks)
+int scissos_proc_run(ScisSosContext *ctx, int pid)
 {
-    // Error handling
-    if (pid < 1 || pid > MAXPROC)
+    // get pcb from process table
+    ScisSosPCB *pcb = scissos_pcb_lookup(ctx, pid);
+
+    if (pcb == NULL)
+    {
+        fprintf(stderr, "Error: Process with PID %d not found.\n", pid);
+        return -1;
+    }
+
+    int start_pc = pcb->pc;
+    int new_state = scissos_proc_start(ctx, pcb);
+    int exec_instr = pcb->pc - start_pc; /* Number of instructions executed */
+
+    ctx->clock += exec_instr; // one clock tick per instruction
+
+    // control goes back to the dispatcher loop in os.c
+    return scissos_proc_finish(ctx, pcb, exec_instr, new_state);
+}
+
+// change the priority of a process; a waiting process is re-ordered in place
+int scissos_proc_set_priority(ScisSosContext *ctx, int pid, int priority)
+{
+    ScisSosPCB *pcb = scissos_pcb_lookup(ctx, pid);
+    if (pcb == NULL)
     {
         fprintf(stderr, "Error: Invalid PID %d.\n", pid);
-        return;
+        return -1;
     }
+    pcb->priority_value = priority;
+    scissos_set_tickets(ctx, pcb, scissos_priority_weight(priority));
+    scissos_ready_update(ctx, pcb);
 
-    ScisSosPCB *pcb = _proctable[pid - 1];
+    return 0;
+}
 
+// restrict the CPUs a process may run on; a ready process queued on a CPU it may no
+// longer use moves now, a running one finishes its quantum first
+int scissos_proc_set_affinity(ScisSosContext *ctx, int pid, unsigned long long mask)
+{
+    ScisSosPCB *pcb = scissos_pcb_lookup(ctx, pid);
     if (pcb == NULL)
     {
-        // Process already deleted or doesn't exist
-        return;
+        fprintf(stderr, "Error: Invalid PID %d.\n", pid);
+        return -1;
     }
+    pcb->affinity = mask;
 
-    // Free code memory
-    if (pcb->p_code)
+    if (pcb->ps_state == PS_RDY && !(scissos_allowed_cpus(ctx, pcb) >> pcb->cpu & 1))
     {
-        for (int i = 0; i < pcb->size; i++)
-        {
-            if (pcb->p_code[i])
-            {
-                free(pcb->p_code[i]);
-            }
-        }
-        free(pcb->p_code);
+        return scissos_migrate(ctx, pcb, scissos_select_cpu(ctx, pcb));
+    }
+
+    return 0;
+}
+
+// Make a process periodic: a job of wcet instructions is released every period ticks,
+// starting now, and must complete within deadline ticks of its release. Admission keeps
+// the total density (wcet / deadline) of real-time processes at most 1, which is
+// sufficient for EDF to meet every deadline on one CPU.
+int scissos_proc_set_realtime(ScisSosContext *ctx, int pid, int period, int deadline, int wcet)
+{
+    ScisSosPCB *pcb = scissos_pcb_lookup(ctx, pid);
+    if (pcb == NULL)
+    {
+        fprintf(stderr, "Error: Invalid PID %d.\n", pid);
+        return -1;
+    }
+    if (wcet <= 0 || deadline < wcet || period < deadline)
+    {
+        fprintf(stderr, "Error: Invalid real-time parameters for PID %d (need 0 < wcet <= deadline <= period).\n", pid);
+        return -1;
+    }
+
+    double density = ctx->rt_density + (double)wcet / deadline;
+    if (pcb->period > 0)
+    {
+        density -= (double)pcb->wcet / pcb->rel_deadline;
+    }
+    if (density > 1.0 + 1e-9)
+    {
+        fprintf(stderr, "Error: PID %d not admitted, real-time density would be %.3f > 1.\n", pid, density);
+        return -1;
+    }
+
+    scissos_rt_release(ctx, pcb);
+    pcb->period = period;
+    pcb->rel_deadline = deadline;
+    pcb->wcet = wcet;
+    pcb->job_done = 0;
+    pcb->t_release = ctx->clock;
+    pcb->t_deadline = ctx->clock + deadline;
+    ctx->rt_count++;
+    ctx->rt_util += (double)wcet / period;
+    ctx->rt_density += (double)wcet / deadline;
+    scissos_ready_update(ctx, pcb);
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "Process PID %d admitted as real-time (period=%d, deadline=%d, wcet=%d)\n",
+                pid, period, deadline, wcet);
+    return 0;
+}
+
+// Delete the process with the given PID
+void scissos_proc_delete(ScisSosContext *ctx, int pid)
+{
+    ScisSosPCB *pcb = scissos_pcb_lookup(ctx, pid);
+
+    if (pcb == NULL)
+    {
+        // Process already deleted or doesn't exist
+        return;
     }
 
+    // Take it out of any queue before releasing it
+    scissos_set_state(ctx, pcb, PS_DEAD);
+    scissos_rt_release(ctx, pcb);
+
+    // Return code block to the arena
+    scissos_arena_release(ctx, pcb->p_code);
+
     // free pcb memory
     free(pcb);
 
-    // Remove from process table
-    _proctable[pid - 1] = NULL;
+    // Remove from process table; the slot is reused under a new generation
+    scissos_pid_release(ctx, pid);
 
-    fprintf(stdout, "Process PID %d deleted from system\n", pid);
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "Process PID %d deleted from system\n", pid);
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "ScisSos.h"
+
+/** Time-slice controller; sizes a process's next quantum from how it used the last one **/
+typedef struct ScisSosQuantum
+{
+    const char *name; /* Name used to select it */
+    /* A quantum of ticks ended in state; set the process's next p_timeslice. NULL keeps it. */
+    void (*on_quantum)(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks, int state);
+} ScisSosQuantum;
+
+/** Time-slice bounds of a process type, in sixteenths of the base time slice **/
+static const struct
+{
+    int lo, hi;
+} quantum_bounds[] = {
+    [PT_REG] = {2, 32},  /* an eighth to twice the base */
+    [PT_CMP] = {8, 128}, /* half to eight times: long bursts run on, fewer switches */
+    [PT_IOE] = {1, 8},   /* a sixteenth to half: a burst of computing cannot hold up the I/O */
+};
+
+// Fold a completed CPU burst into the process's exponential average
+static void scissos_burst_average(ScisSosPCB *pcb)
+{
+    if (pcb->burst_avg == 0)
+    {
+        pcb->burst_avg = pcb->burst_run; // the first burst is the whole history
+    }
+    else
+    {
+        pcb->burst_avg += (pcb->burst_run - pcb->burst_avg) >> BURST_DECAY;
+    }
+    pcb->burst_run = 0;
+}
+
+// Steer the global slice scale towards the context-switch rate target: more preemptions
+// than aimed for lengthen every slice, fewer shorten them to win back latency
+static void scissos_quantum_steer(ScisSosContext *ctx)
+{
+    ScisSosTime elapsed = ctx->clock - ctx->window_start;
+    if (elapsed < QUANTUM_WINDOW)
+    {
+        return;
+    }
+
+    // preemptions per CPU, normalised to one window
+    double rate = (double)ctx->window_preemptions * QUANTUM_WINDOW / elapsed / ctx->ncpu;
+    if (rate > ctx->switch_target && ctx->quantum_scale < QUANTUM_ONE * QUANTUM_SCALE_MAX)
+    {
+        ctx->quantum_scale += ctx->quantum_scale / 4;
+    }
+    else if (rate < ctx->switch_target && ctx->quantum_scale > QUANTUM_ONE / QUANTUM_SCALE_MAX)
+    {
+        ctx->quantum_scale -= ctx->quantum_scale / 5;
+    }
+
+    ctx->window_start = ctx->clock;
+    ctx->window_preemptions = 0;
+}
+
+// Adaptive: give the next quantum room for QUANTUM_FIT times the predicted burst, scaled by
+// the switch-rate target and kept within the bounds of the process type. A burst that is
+// still running when preempted has already outgrown the average, so it counts as it stands.
+static void scissos_quantum_adaptive(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks, int state)
+{
+    pcb->burst_run += ticks;
+    if (state == PS_RDY)
+    {
+        ctx->window_preemptions++;
+    }
+    else
+    {
+        scissos_burst_average(pcb);
+    }
+    scissos_quantum_steer(ctx);
+
+    long long predicted = pcb->burst_run > pcb->burst_avg ? pcb->burst_run : pcb->burst_avg;
+    long long slice = predicted * QUANTUM_FIT * ctx->quantum_scale / QUANTUM_ONE;
+    long long lo = (long long)ctx->timeslice * quantum_bounds[pcb->p_type].lo / 16;
+    long long hi = (long long)ctx->timeslice * quantum_bounds[pcb->p_type].hi / 16;
+
+    slice = slice < lo ? lo : slice > hi ? hi : slice;
+    pcb->p_timeslice = slice > 0 ? (int)slice : 1;
+}
+
+/** Registered time-slice controllers **/
+static const ScisSosQuantum quanta[] = {
+    {"fixed", NULL},
+    {"adaptive", scissos_quantum_adaptive},
+};
+
+#define NUM_QUANTA (int)(sizeof(quanta) / sizeof(quanta[0]))
+
+// Select a time-slice controller by name; target is the preemptions per CPU in every
+// QUANTUM_WINDOW ticks the adaptive controller aims for
+int scissos_set_quantum(ScisSosContext *ctx, const char *name, int target)
+{
+    if (target <= 0)
+    {
+        fprintf(stderr, "Error: Invalid context-switch target %d. Must be positive.\n", target);
+        return -1;
+    }
+
+    for (int i = 0; i < NUM_QUANTA; i++)
+    {
+        if (strcmp(quanta[i].name, name) == 0)
+        {
+            ctx->quantum = &quanta[i];
+            ctx->switch_target = target;
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "Error: Unknown time-slice controller '%s' (use fixed or adaptive:N)\n", name);
+    return -1;
+}
+
+// Parse "fixed", "adaptive" or "adaptive:N" and apply it
+int scissos_parse_quantum(ScisSosContext *ctx, const char *spec)
+{
+    char name[32];
+    const char *colon = strchr(spec, ':');
+    size_t len = colon ? (size_t)(colon - spec) : strlen(spec);
+
+    if (len >= sizeof(name))
+    {
+        fprintf(stderr, "Error: Unknown time-slice controller '%s' (use fixed or adaptive:N)\n", spec);
+        return -1;
+    }
+    memcpy(name, spec, len);
+    name[len] = '\0';
+
+    return scissos_set_quantum(ctx, name, colon ? atoi(colon + 1) : DEFSWITCH);
+}
+
+// Start a run with an unscaled slice and a fresh switch-rate window
+void scissos_quantum_reset(ScisSosContext *ctx)
+{
+    ctx->quantum_scale = QUANTUM_ONE;
+    ctx->window_start = 0;
+    ctx->window_preemptions = 0;
+}
+
+// A quantum of ticks ended in state: let the controller size the next one
+void scissos_quantum_update(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks, int state)
+{
+    if (state == PS_RDY)
+    {
+        pcb->preemptions++;
+    }
+    if (ctx->quantum != NULL && ctx->quantum->on_quantum != NULL)
+    {
+        ctx->quantum->on_quantum(ctx, pcb, ticks, state);
+    }
+}
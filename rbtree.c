@@ -0,0 +1,309 @@
+#include "scheduling_algo.h"
+
+// Order two tree nodes: smaller key first, ties broken by lower ID
+static int scissos_rb_less(const ScisSosRbNode *a, const ScisSosRbNode *b)
+{
+    return a->key < b->key || (a->key == b->key && a->id < b->id);
+}
+
+// Leftmost node of a subtree
+static ScisSosRbNode *scissos_rb_min(ScisSosRbNode *node)
+{
+    while (node->left != NULL)
+    {
+        node = node->left;
+    }
+    return node;
+}
+
+// Put v where u hangs in the tree
+static void scissos_rb_replace(ScisSosRbTree *tree, ScisSosRbNode *u, ScisSosRbNode *v)
+{
+    if (u->parent == NULL)
+    {
+        tree->root = v;
+    }
+    else if (u == u->parent->left)
+    {
+        u->parent->left = v;
+    }
+    else
+    {
+        u->parent->right = v;
+    }
+
+    if (v != NULL)
+    {
+        v->parent = u->parent;
+    }
+}
+
+// Rotate x down to the left; its right child takes its place
+static void scissos_rb_rotate_left(ScisSosRbTree *tree, ScisSosRbNode *x)
+{
+    ScisSosRbNode *y = x->right;
+
+    x->right = y->left;
+    if (y->left != NULL)
+    {
+        y->left->parent = x;
+    }
+    scissos_rb_replace(tree, x, y);
+    y->left = x;
+    x->parent = y;
+}
+
+// Rotate x down to the right; its left child takes its place
+static void scissos_rb_rotate_right(ScisSosRbTree *tree, ScisSosRbNode *x)
+{
+    ScisSosRbNode *y = x->left;
+
+    x->left = y->right;
+    if (y->right != NULL)
+    {
+        y->right->parent = x;
+    }
+    scissos_rb_replace(tree, x, y);
+    y->right = x;
+    x->parent = y;
+}
+
+// Node colour; empty leaves are black
+static int scissos_rb_red(const ScisSosRbNode *node)
+{
+    return node != NULL && node->red;
+}
+
+// Empty tree
+void scissos_rb_init(ScisSosRbTree *tree)
+{
+    tree->root = NULL;
+    tree->leftmost = NULL;
+    tree->count = 0;
+}
+
+// Insert a node under the given key and owner ID in O(log n)
+void scissos_rb_insert(ScisSosRbTree *tree, ScisSosRbNode *node, long long key, int id)
+{
+    ScisSosRbNode *parent = NULL;
+    ScisSosRbNode **link = &tree->root;
+    int leftmost = 1;
+
+    node->key = key;
+    node->id = id;
+    node->left = NULL;
+    node->right = NULL;
+    node->red = 1;
+
+    while (*link != NULL)
+    {
+        parent = *link;
+        if (scissos_rb_less(node, parent))
+        {
+            link = &parent->left;
+        }
+        else
+        {
+            link = &parent->right;
+            leftmost = 0;
+        }
+    }
+
+    node->parent = parent;
+    *link = node;
+    if (leftmost)
+    {
+        tree->leftmost = node;
+    }
+    tree->count++;
+
+    // Restore the colour rules: no red node has a red parent
+    while (scissos_rb_red(node->parent))
+    {
+        ScisSosRbNode *p = node->parent;
+        ScisSosRbNode *g = p->parent; // exists, the root is black
+
+        if (p == g->left)
+        {
+            ScisSosRbNode *uncle = g->right;
+            if (scissos_rb_red(uncle))
+            {
+                p->red = 0;
+                uncle->red = 0;
+                g->red = 1;
+                node = g;
+                continue;
+            }
+            if (node == p->right)
+            {
+                scissos_rb_rotate_left(tree, p);
+                p = node;
+            }
+            p->red = 0;
+            g->red = 1;
+            scissos_rb_rotate_right(tree, g);
+            break; // the subtree root is black again
+        }
+        else
+        {
+            ScisSosRbNode *uncle = g->left;
+            if (scissos_rb_red(uncle))
+            {
+                p->red = 0;
+                uncle->red = 0;
+                g->red = 1;
+                node = g;
+                continue;
+            }
+            if (node == p->left)
+            {
+                scissos_rb_rotate_right(tree, p);
+                p = node;
+            }
+            p->red = 0;
+            g->red = 1;
+            scissos_rb_rotate_left(tree, g);
+            break; // the subtree root is black again
+        }
+    }
+
+    tree->root->red = 0;
+}
+
+// Rebalance after a black node was unlinked; x (possibly empty) under parent is one black short
+static void scissos_rb_remove_fixup(ScisSosRbTree *tree, ScisSosRbNode *x, ScisSosRbNode *parent)
+{
+    while (x != tree->root && !scissos_rb_red(x))
+    {
+        if (x == parent->left)
+        {
+            ScisSosRbNode *w = parent->right;
+            if (w->red)
+            {
+                w->red = 0;
+                parent->red = 1;
+                scissos_rb_rotate_left(tree, parent);
+                w = parent->right;
+            }
+            if (!scissos_rb_red(w->left) && !scissos_rb_red(w->right))
+            {
+                w->red = 1;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+            if (!scissos_rb_red(w->right))
+            {
+                w->left->red = 0;
+                w->red = 1;
+                scissos_rb_rotate_right(tree, w);
+                w = parent->right;
+            }
+            w->red = parent->red;
+            parent->red = 0;
+            w->right->red = 0;
+            scissos_rb_rotate_left(tree, parent);
+        }
+        else
+        {
+            ScisSosRbNode *w = parent->left;
+            if (w->red)
+            {
+                w->red = 0;
+                parent->red = 1;
+                scissos_rb_rotate_right(tree, parent);
+                w = parent->left;
+            }
+            if (!scissos_rb_red(w->left) && !scissos_rb_red(w->right))
+            {
+                w->red = 1;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+            if (!scissos_rb_red(w->left))
+            {
+                w->right->red = 0;
+                w->red = 1;
+                scissos_rb_rotate_left(tree, w);
+                w = parent->left;
+            }
+            w->red = parent->red;
+            parent->red = 0;
+            w->left->red = 0;
+            scissos_rb_rotate_right(tree, parent);
+        }
+        x = tree->root;
+    }
+
+    if (x != NULL)
+    {
+        x->red = 0;
+    }
+}
+
+// Remove a node from the tree in O(log n)
+void scissos_rb_remove(ScisSosRbTree *tree, ScisSosRbNode *z)
+{
+    ScisSosRbNode *x, *parent;
+    int removed_red = z->red;
+
+    // The leftmost node has no left child, so its successor is close by
+    if (tree->leftmost == z)
+    {
+        tree->leftmost = z->right != NULL ? scissos_rb_min(z->right) : z->parent;
+    }
+
+    if (z->left == NULL)
+    {
+        x = z->right;
+        parent = z->parent;
+        scissos_rb_replace(tree, z, z->right);
+    }
+    else if (z->right == NULL)
+    {
+        x = z->left;
+        parent = z->parent;
+        scissos_rb_replace(tree, z, z->left);
+    }
+    else
+    {
+        // Two children: the successor takes z's place and colour
+        ScisSosRbNode *y = scissos_rb_min(z->right);
+        removed_red = y->red;
+        x = y->right;
+
+        if (y->parent == z)
+        {
+            parent = y;
+        }
+        else
+        {
+            parent = y->parent;
+            scissos_rb_replace(tree, y, y->right);
+            y->right = z->right;
+            y->right->parent = y;
+        }
+
+        scissos_rb_replace(tree, z, y);
+        y->left = z->left;
+        y->left->parent = y;
+        y->red = z->red;
+    }
+
+    if (!removed_red)
+    {
+        scissos_rb_remove_fixup(tree, x, parent);
+    }
+
+    z->parent = NULL;
+    z->left = NULL;
+    z->right = NULL;
+    tree->count--;
+}
+
+// ID of the node with the smallest key in O(1), EMPTY if the tree is empty
+int scissos_rb_first(const ScisSosRbTree *tree)
+{
+    return tree->leftmost != NULL ? tree->leftmost->id : EMPTY;
+}
@@ -0,0 +1,55 @@
+#include "ScisSos.h"
+
+// splitmix64 step; spreads a seed over the whole 64-bit range
+static unsigned long long scissos_splitmix64(unsigned long long *x)
+{
+    unsigned long long z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static unsigned long long scissos_rotl(unsigned long long x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Seed a generator for one stream (e.g. a PID) of a master seed; equal inputs give equal sequences
+void scissos_rng_seed(ScisSosRng *rng, unsigned long long seed, unsigned long long stream)
+{
+    unsigned long long x = seed ^ scissos_splitmix64(&stream);
+
+    for (int i = 0; i < 4; i++)
+    {
+        rng->s[i] = scissos_splitmix64(&x);
+    }
+}
+
+// Next 64 random bits (xoshiro256**)
+unsigned long long scissos_rng_next(ScisSosRng *rng)
+{
+    unsigned long long *s = rng->s;
+    unsigned long long result = scissos_rotl(s[1] * 5, 7) * 9;
+    unsigned long long t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = scissos_rotl(s[3], 45);
+
+    return result;
+}
+
+// Uniform double in [0, 1) from the top 53 bits
+double scissos_rng_double(ScisSosRng *rng)
+{
+    return (scissos_rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+// Uniform integer in [0, n) by multiply-shift, for n > 0
+int scissos_rng_below(ScisSosRng *rng, int n)
+{
+    return (int)(((scissos_rng_next(rng) >> 32) * (unsigned long long)n) >> 32);
+}
@@ -1,168 +1,772 @@
+#include <limits.h>
+#include <math.h>
 #include "scheduling_algo.h"
 
-static int last_scheduled_index = -1;
+// Heap key for SJF: instructions left to execute
+static int scissos_sjf_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_heap_push(&ctx->rq->ready_heap, pcb, pcb->size - pcb->pc);
+}
 
-// First Come First Serve Algorithm --> Based on arrival time
-int scissos_schedule_fcfs(int *readyQ, int qsize)
+// Heap key for priority: lower value means higher priority
+static int scissos_priority_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_heap_push(&ctx->rq->ready_heap, pcb, pcb->priority_value);
+}
+
+// Priority changed while the process is waiting
+static void scissos_priority_on_update(ScisSosContext *ctx, ScisSosPCB *pcb)
 {
-    if (qsize <= 0 || readyQ == NULL || readyQ[0] == EMPTY)
+    scissos_heap_update(&ctx->rq->ready_heap, pcb, pcb->priority_value);
+}
+
+// Process left the ready set
+static void scissos_heap_on_unready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    scissos_heap_remove(&ctx->rq->ready_heap, pcb);
+}
+
+// MLFQ level of a process; a boost since it was last queued puts it back on top
+static int scissos_mlfq_level(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    if (pcb->level_epoch != ctx->mlfq_epoch)
     {
-        return EMPTY;
+        pcb->level = 0;
+        pcb->level_epoch = ctx->mlfq_epoch;
     }
+    return pcb->level;
+}
 
-    fprintf(stdout, "[SCHEDULER: FCFS] Selecting first process in queue\n");
-    return readyQ[0];
+// Quantum of an MLFQ level: the time slice at the bottom, halved for each level above
+static int scissos_mlfq_quantum(ScisSosContext *ctx, int level)
+{
+    int quantum = ctx->timeslice >> (MLFQ_LEVELS - 1 - level);
+    return quantum > 0 ? quantum : 1;
 }
 
-// Shortest Job First Algorithm --> Based on remaining instructions left
-int scissos_schedule_sjf(int *readyQ, int qsize)
+// Append a ready process to the queue of its level
+static int scissos_mlfq_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
 {
-    if (qsize <= 0 || readyQ == NULL || readyQ[0] == EMPTY)
+    int level = scissos_mlfq_level(ctx, pcb);
+    ScisSosQueue *q = &ctx->rq->mlfq[level];
+
+    pcb->l_next = EMPTY;
+    pcb->l_prev = q->tail;
+    if (q->tail != EMPTY)
     {
-        return EMPTY;
+        PCB_OF(ctx, q->tail)->l_next = pcb->pid;
     }
+    else
+    {
+        q->head = pcb->pid;
+    }
+    q->tail = pcb->pid;
+    q->count++;
+    ctx->rq->mlfq_mask |= 1u << level;
+    return 0;
+}
 
-    int selected_pid = readyQ[0];
+// Unlink a process from the queue of its level
+static void scissos_mlfq_on_unready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    int level = scissos_mlfq_level(ctx, pcb);
+    ScisSosQueue *q = &ctx->rq->mlfq[level];
 
-    // Validate first PID
-    if (selected_pid < 1 || selected_pid > MAXPROC || _proctable[selected_pid - 1] == NULL)
+    if (pcb->l_prev != EMPTY)
     {
-        fprintf(stderr, "Error: Invalid PID %d in ready queue\n", selected_pid);
-        return EMPTY;
+        PCB_OF(ctx, pcb->l_prev)->l_next = pcb->l_next;
+    }
+    else
+    {
+        q->head = pcb->l_next;
+    }
+    if (pcb->l_next != EMPTY)
+    {
+        PCB_OF(ctx, pcb->l_next)->l_prev = pcb->l_prev;
+    }
+    else
+    {
+        q->tail = pcb->l_prev;
+    }
+    pcb->l_next = EMPTY;
+    pcb->l_prev = EMPTY;
+
+    if (--q->count == 0)
+    {
+        ctx->rq->mlfq_mask &= ~(1u << level);
+    }
+}
+
+// Used its whole quantum: CPU-bound so far, move down a level
+static void scissos_mlfq_on_expire(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    if (scissos_mlfq_level(ctx, pcb) < MLFQ_LEVELS - 1)
+    {
+        pcb->level++;
     }
+}
 
-    int remaining = _proctable[selected_pid - 1]->size - _proctable[selected_pid - 1]->pc;
+// Blocked before its quantum ran out: interactive, move up a level
+static void scissos_mlfq_on_block(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    if (scissos_mlfq_level(ctx, pcb) > 0)
+    {
+        pcb->level--;
+    }
+}
 
-    // Find process with shortest remaining time
-    for (int i = 1; i < qsize && readyQ[i] != EMPTY; i++)
+// Lift every process to the top level so long-running ones cannot starve. Ready queues of
+// every CPU are spliced onto level 0 in level order; the others find out through the new epoch.
+static void scissos_mlfq_boost(ScisSosContext *ctx)
+{
+    for (int c = 0; c < ctx->ncpu; c++)
     {
-        int pid = readyQ[i];
+        ScisSosRunQueue *rq = &ctx->cpus[c].rq;
+        ScisSosQueue *top = &rq->mlfq[0];
 
-        // Validate PID before accessing process table
-        if (pid < 1 || pid > MAXPROC)
+        for (int l = 1; l < MLFQ_LEVELS; l++)
         {
-            fprintf(stderr, "Error: Invalid PID %d in ready queue at index %d\n", pid, i);
-            continue;
+            ScisSosQueue *q = &rq->mlfq[l];
+            if (q->count == 0)
+            {
+                continue;
+            }
+
+            if (top->tail != EMPTY)
+            {
+                PCB_OF(ctx, top->tail)->l_next = q->head;
+                PCB_OF(ctx, q->head)->l_prev = top->tail;
+            }
+            else
+            {
+                top->head = q->head;
+            }
+            top->tail = q->tail;
+            top->count += q->count;
+            scissos_queue_init(q);
         }
 
-        ScisSosPCB *pcb = _proctable[pid - 1];
-        if (pcb == NULL)
+        rq->mlfq_mask = top->count > 0 ? 1u : 0u;
+    }
+
+    ctx->mlfq_epoch++;
+    ctx->next_boost = ctx->clock + ctx->boost_period;
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[BOOST] All processes moved to the top MLFQ level\n");
+}
+
+// CFS weight and proportional-share tickets of a priority: DEFPRIO maps to nice 0, each
+// step is about 10% of CPU share
+int scissos_priority_weight(int priority)
+{
+    static const int nice_weight[40] = {
+        88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+        9548, 7620, 6100, 4904, 3906, 3121, 2501, 1991, 1586, 1277,
+        1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+        110, 87, 70, 56, 45, 36, 29, 23, 18, 15};
+    int nice = priority - DEFPRIO;
+
+    if (nice < -20)
+    {
+        nice = -20;
+    }
+    else if (nice > 19)
+    {
+        nice = 19;
+    }
+    return nice_weight[nice + 20];
+}
+
+// Enter the run queue. A new process starts level with min_vruntime, so a burst of
+// arrivals cannot starve the processes already running. One back from a long sleep keeps
+// at most half a latency period of credit: it runs ahead of the others, but not for all
+// the time it slept. One coming from another CPU keeps its lead or lag relative to that
+// CPU's min_vruntime.
+static int scissos_cfs_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    if (pcb->vr_cpu != pcb->cpu)
+    {
+        pcb->vruntime += ctx->cpus[pcb->cpu].rq.min_vruntime - ctx->cpus[pcb->vr_cpu].rq.min_vruntime;
+        pcb->vr_cpu = pcb->cpu;
+    }
+
+    long long floor = ctx->rq->min_vruntime;
+
+    if (pcb->t_first_run != NO_TIME)
+    {
+        floor -= (long long)(CFS_LATENCY / 2) << CFS_SHIFT;
+    }
+    if (pcb->vruntime < floor)
+    {
+        pcb->vruntime = floor;
+    }
+    pcb->weight = scissos_priority_weight(pcb->priority_value);
+    ctx->rq->cfs_weight += pcb->weight;
+    scissos_rb_insert(&ctx->rq->cfs_tree, &pcb->rb, pcb->vruntime, pcb->pid);
+    return 0;
+}
+
+// Leave the run queue
+static void scissos_cfs_on_unready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    scissos_rb_remove(&ctx->rq->cfs_tree, &pcb->rb);
+    ctx->rq->cfs_weight -= pcb->weight;
+}
+
+// Priority changed while waiting; the position (vruntime) stays, the share changes
+static void scissos_cfs_on_update(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    int weight = scissos_priority_weight(pcb->priority_value);
+
+    ctx->rq->cfs_weight += weight - pcb->weight;
+    pcb->weight = weight;
+}
+
+// Advance virtual runtime in inverse proportion to the weight
+static void scissos_cfs_on_charge(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks)
+{
+    (void)ctx;
+    pcb->vruntime += ((long long)ticks << CFS_SHIFT) * NICE_0_WEIGHT / scissos_priority_weight(pcb->priority_value);
+}
+
+// Set a user's usage, moving it in the user tree of every CPU it has ready processes on
+static void scissos_fshare_set_usage(ScisSosContext *ctx, int uid, long long usage)
+{
+    for (int c = 0; c < ctx->ncpu; c++)
+    {
+        ScisSosRunQueue *rq = &ctx->cpus[c].rq;
+        if (rq->users[uid].ready.count > 0)
         {
-            fprintf(stderr, "Error: NULL PCB for PID %d\n", pid);
-            continue;
+            scissos_rb_remove(&rq->user_tree, &rq->users[uid].node);
+            scissos_rb_insert(&rq->user_tree, &rq->users[uid].node, usage, uid);
         }
+    }
+    ctx->user_usage[uid] = usage;
+}
 
-        int rem = pcb->size - pcb->pc;
+// Queue a ready process with its user under the inner policy's key. A user becoming ready
+// joins the user tree no further back than the least-served user being scheduled, so it
+// cannot monopolise the CPU with share saved up while idle.
+static int scissos_fshare_enqueue(ScisSosContext *ctx, ScisSosPCB *pcb, long long key)
+{
+    ScisSosUser *user = &ctx->rq->users[pcb->uid];
 
-        if (rem < remaining)
+    if (user->ready.count == 0)
+    {
+        if (ctx->user_usage[pcb->uid] < ctx->min_usage)
         {
-            remaining = rem;
-            selected_pid = pid;
+            scissos_fshare_set_usage(ctx, pcb->uid, ctx->min_usage);
         }
+        scissos_rb_insert(&ctx->rq->user_tree, &user->node, ctx->user_usage[pcb->uid], pcb->uid);
+    }
+    scissos_rb_insert(&user->ready, &pcb->rb, key, pcb->pid);
+    return 0;
+}
+
+// Inner round robin: arrival order within the user
+static int scissos_fshare_rr_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_fshare_enqueue(ctx, pcb, ctx->rq->fshare_seq++);
+}
+
+// Inner SJF: instructions left to execute
+static int scissos_fshare_sjf_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_fshare_enqueue(ctx, pcb, pcb->size - pcb->pc);
+}
+
+// Inner priority: lower value first
+static int scissos_fshare_priority_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_fshare_enqueue(ctx, pcb, pcb->priority_value);
+}
+
+// Priority changed while waiting: re-order within the user
+static void scissos_fshare_priority_on_update(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    ScisSosUser *user = &ctx->rq->users[pcb->uid];
+
+    scissos_rb_remove(&user->ready, &pcb->rb);
+    scissos_rb_insert(&user->ready, &pcb->rb, pcb->priority_value, pcb->pid);
+}
+
+// Leave the user's queue; a user without ready processes leaves the user tree
+static void scissos_fshare_on_unready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    ScisSosUser *user = &ctx->rq->users[pcb->uid];
+
+    scissos_rb_remove(&user->ready, &pcb->rb);
+    if (user->ready.count == 0)
+    {
+        scissos_rb_remove(&ctx->rq->user_tree, &user->node);
+    }
+}
+
+// Charge CPU time to the user, moving it back in the user trees it is in
+static void scissos_fshare_on_charge(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks)
+{
+    scissos_fshare_set_usage(ctx, pcb->uid, ctx->user_usage[pcb->uid] + ticks);
+}
+
+// Heap key for EDF: absolute deadline of the current job, best-effort processes last
+static long long scissos_edf_key(const ScisSosPCB *pcb)
+{
+    return pcb->period > 0 ? (long long)pcb->t_deadline : RT_BACKGROUND;
+}
+
+static int scissos_edf_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_heap_push(&ctx->rq->ready_heap, pcb, scissos_edf_key(pcb));
+}
+
+static void scissos_edf_on_update(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    scissos_heap_update(&ctx->rq->ready_heap, pcb, scissos_edf_key(pcb));
+}
+
+// Heap key for rate monotonic: shorter period first, best-effort processes last
+static long long scissos_rm_key(const ScisSosPCB *pcb)
+{
+    return pcb->period > 0 ? pcb->period : RT_BACKGROUND;
+}
+
+static int scissos_rm_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_heap_push(&ctx->rq->ready_heap, pcb, scissos_rm_key(pcb));
+}
+
+static void scissos_rm_on_update(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    scissos_heap_update(&ctx->rq->ready_heap, pcb, scissos_rm_key(pcb));
+}
+
+// Lottery: a ready process holds its tickets in the tree at its table slot
+static int scissos_lottery_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    return scissos_fenwick_add(&ctx->rq->lottery, PID_SLOT(pcb->pid), pcb->lottery_tickets);
+}
+
+static void scissos_lottery_on_unready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    int slot = PID_SLOT(pcb->pid);
+    scissos_fenwick_add(&ctx->rq->lottery, slot, -scissos_fenwick_get(&ctx->rq->lottery, slot));
+}
+
+// Tickets changed while the process is waiting
+static void scissos_lottery_on_update(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    int slot = PID_SLOT(pcb->pid);
+    pcb->lottery_tickets = pcb->tickets;
+    scissos_fenwick_add(&ctx->rq->lottery, slot, pcb->tickets - scissos_fenwick_get(&ctx->rq->lottery, slot));
+}
+
+// Compensation tickets: a process that used only part of its quantum holds proportionally
+// more tickets until it next runs, so its share does not shrink with its burst length
+static void scissos_lottery_on_charge(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks)
+{
+    (void)ctx;
+    if (ticks > 0 && ticks < pcb->p_timeslice)
+    {
+        pcb->lottery_tickets = (long long)pcb->tickets * pcb->p_timeslice / ticks;
+    }
+    else
+    {
+        pcb->lottery_tickets = pcb->tickets;
+    }
+}
+
+// Stride: heap key is the pass. A process joining after a sleep starts at the global pass,
+// so it neither catches up on service it missed nor pays for a lead it built earlier.
+static int scissos_stride_on_ready(ScisSosContext *ctx, ScisSosPCB *pcb)
+{
+    if (pcb->pass < ctx->share_pass)
+    {
+        pcb->pass = ctx->share_pass;
     }
+    return scissos_heap_push(&ctx->rq->ready_heap, pcb, pcb->pass);
+}
 
-    fprintf(stdout, "[SCHEDULER: SJF] Selected process %d (remaining=%d instructions)\n",
-            selected_pid, remaining);
+// Advance the pass by the ticks used times the stride (inverse of the tickets)
+static void scissos_stride_on_charge(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks)
+{
+    (void)ctx;
+    pcb->pass += ((long long)ticks << SHARE_SHIFT) / pcb->tickets;
+}
+
+// First Come First Serve Algorithm --> Based on arrival time
+int scissos_schedule_fcfs(ScisSosContext *ctx)
+{
+    if (ctx->rq->readyQ.head == EMPTY)
+    {
+        return EMPTY;
+    }
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: FCFS] Selecting first process in queue\n");
+    return ctx->rq->readyQ.head;
+}
+
+// Shortest Job First Algorithm --> Based on remaining instructions left
+int scissos_schedule_sjf(ScisSosContext *ctx)
+{
+    if (ctx->rq->readyQ.head == EMPTY || ctx->rq->ready_heap.size == 0)
+    {
+        return EMPTY;
+    }
+
+    // Heap top is the process with shortest remaining time
+    int selected_pid = scissos_heap_top(&ctx->rq->ready_heap);
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: SJF] Selected process %d (remaining=%lld instructions)\n",
+                selected_pid, ctx->rq->ready_heap.nodes[0].key);
 
     return selected_pid;
 }
 
 // Priority Algorithm --> Based on process priority
-int scissos_schedule_priority(int *readyQ, int qsize)
+int scissos_schedule_priority(ScisSosContext *ctx)
 {
-    if (qsize <= 0 || readyQ == NULL || readyQ[0] == EMPTY)
+    if (ctx->rq->readyQ.head == EMPTY || ctx->rq->ready_heap.size == 0)
     {
         return EMPTY;
     }
 
-    int selected_pid = readyQ[0];
+    // Heap top is the process with lowest priority value (highest priority)
+    int selected_pid = scissos_heap_top(&ctx->rq->ready_heap);
 
-    // Validate first PID
-    if (selected_pid < 1 || selected_pid > MAXPROC || _proctable[selected_pid - 1] == NULL)
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: PRIORITY] Selected process %d (priority=%lld)\n",
+                selected_pid, ctx->rq->ready_heap.nodes[0].key);
+
+    return selected_pid;
+}
+
+// Round Robin Algorithm --> Based on time slice
+int scissos_schedule_rr(ScisSosContext *ctx)
+{
+    if (ctx->rq->readyQ.head == EMPTY)
     {
-        fprintf(stderr, "Error: Invalid PID %d in ready queue\n", selected_pid);
         return EMPTY;
     }
 
-    int highest_priority = _proctable[selected_pid - 1]->priority_value;
+    // Preempted processes are re-queued at the tail, so the head is next in turn
+    int selected_pid = ctx->rq->readyQ.head;
 
-    // Find process with lowest priority value (highest priority)
-    for (int i = 1; i < qsize && readyQ[i] != EMPTY; i++)
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: ROUND ROBIN] Selected process %d (%d in queue)\n",
+                selected_pid, ctx->rq->readyQ.count);
+    return selected_pid;
+}
+
+// Multi-Level Feedback Queue Algorithm --> Round robin within the highest non-empty level
+int scissos_schedule_mlfq(ScisSosContext *ctx)
+{
+    if (ctx->clock >= ctx->next_boost)
     {
-        int pid = readyQ[i];
+        scissos_mlfq_boost(ctx);
+    }
 
-        // Validate PID before accessing process table
-        if (pid < 1 || pid > MAXPROC)
-        {
-            fprintf(stderr, "Error: Invalid PID %d in ready queue at index %d\n", pid, i);
-            continue;
-        }
+    if (ctx->rq->mlfq_mask == 0)
+    {
+        return EMPTY;
+    }
 
-        ScisSosPCB *pcb = _proctable[pid - 1];
-        if (pcb == NULL)
-        {
-            fprintf(stderr, "Error: NULL PCB for PID %d\n", pid);
-            continue;
-        }
+    int level = __builtin_ctz(ctx->rq->mlfq_mask);
+    int selected_pid = ctx->rq->mlfq[level].head;
 
-        int priority = pcb->priority_value;
+    // A process spliced up by a boost still carries its old level
+    ScisSosPCB *pcb = PCB_OF(ctx, selected_pid);
+    pcb->level = level;
+    pcb->level_epoch = ctx->mlfq_epoch;
+    pcb->p_timeslice = scissos_mlfq_quantum(ctx, level);
 
-        if (priority < highest_priority)
-        {
-            highest_priority = priority;
-            selected_pid = pid;
-        }
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: MLFQ] Selected process %d (level=%d, quantum=%d)\n",
+                selected_pid, level, pcb->p_timeslice);
+    return selected_pid;
+}
+
+// Completely Fair Scheduler --> Smallest virtual runtime, slice shared out by weight
+int scissos_schedule_cfs(ScisSosContext *ctx)
+{
+    int selected_pid = scissos_rb_first(&ctx->rq->cfs_tree);
+    if (selected_pid == EMPTY)
+    {
+        return EMPTY;
     }
 
-    fprintf(stdout, "[SCHEDULER: PRIORITY] Selected process %d (priority=%d)\n",
-            selected_pid, highest_priority);
+    ScisSosPCB *pcb = PCB_OF(ctx, selected_pid);
+    if (pcb->vruntime > ctx->rq->min_vruntime)
+    {
+        ctx->rq->min_vruntime = pcb->vruntime;
+    }
 
+    // Every runnable process gets a turn within the target latency, unless that would
+    // cut slices below the minimum granularity
+    long long period = CFS_LATENCY;
+    if ((long long)ctx->rq->cfs_tree.count * CFS_MIN_GRAN > period)
+    {
+        period = (long long)ctx->rq->cfs_tree.count * CFS_MIN_GRAN;
+    }
+    long long slice = period * pcb->weight / ctx->rq->cfs_weight;
+    pcb->p_timeslice = (int)(slice > CFS_MIN_GRAN ? (slice < INT_MAX ? slice : INT_MAX) : CFS_MIN_GRAN);
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: CFS] Selected process %d (vruntime=%lld, slice=%d, %d runnable)\n",
+                selected_pid, pcb->vruntime >> CFS_SHIFT, pcb->p_timeslice, ctx->rq->cfs_tree.count);
     return selected_pid;
 }
 
-// Round Robin Algorithm --> Based on time slice
-int scissos_schedule_rr(int *readyQ, int qsize)
+// Fair Share Algorithm --> Least-served user first, then the inner policy among its processes
+int scissos_schedule_fshare(ScisSosContext *ctx)
+{
+    int uid = scissos_rb_first(&ctx->rq->user_tree);
+    if (uid == EMPTY)
+    {
+        return EMPTY;
+    }
+
+    if (ctx->user_usage[uid] > ctx->min_usage)
+    {
+        ctx->min_usage = ctx->user_usage[uid];
+    }
+
+    int selected_pid = scissos_rb_first(&ctx->rq->users[uid].ready);
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: FAIR SHARE] Selected process %d of user %d (usage=%lld, %d users ready)\n",
+                selected_pid, uid, ctx->user_usage[uid], ctx->rq->user_tree.count);
+    return selected_pid;
+}
+
+// Earliest Deadline First Algorithm --> Based on the absolute deadline of the current job
+int scissos_schedule_edf(ScisSosContext *ctx)
+{
+    if (ctx->rq->ready_heap.size == 0)
+    {
+        return EMPTY;
+    }
+
+    int selected_pid = scissos_heap_top(&ctx->rq->ready_heap);
+    long long key = ctx->rq->ready_heap.nodes[0].key;
+
+    if (key == RT_BACKGROUND)
+    {
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: EDF] Selected best-effort process %d\n", selected_pid);
+    }
+    else
+    {
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: EDF] Selected process %d (deadline=%lld)\n", selected_pid, key);
+    }
+    return selected_pid;
+}
+
+// Rate Monotonic Algorithm --> Static priority, shortest period first
+int scissos_schedule_rm(ScisSosContext *ctx)
 {
-    if (qsize <= 0 || readyQ == NULL)
+    if (ctx->rq->ready_heap.size == 0)
     {
         return EMPTY;
     }
 
-    // Reset if last_scheduled_index is out of bounds
-    if (last_scheduled_index >= qsize || last_scheduled_index < -1)
+    int selected_pid = scissos_heap_top(&ctx->rq->ready_heap);
+    long long key = ctx->rq->ready_heap.nodes[0].key;
+
+    if (key == RT_BACKGROUND)
+    {
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: RM] Selected best-effort process %d\n", selected_pid);
+    }
+    else
     {
-        last_scheduled_index = -1;
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: RM] Selected process %d (period=%lld)\n", selected_pid, key);
     }
+    return selected_pid;
+}
 
-    int start_index = (last_scheduled_index + 1) % qsize;
-    int selected_pid = EMPTY;
+// Lottery Algorithm --> Random draw weighted by tickets
+int scissos_schedule_lottery(ScisSosContext *ctx)
+{
+    long long total = ctx->rq->lottery.total;
+    if (total <= 0)
+    {
+        return EMPTY;
+    }
+
+    long long winner = (long long)(scissos_rng_next(&ctx->lottery_rng) % (unsigned long long)total);
+    int selected_pid = ctx->proctable[scissos_fenwick_find(&ctx->rq->lottery, winner)]->pid;
 
-    // Loop through ready queue circularly to find the next valid process
-    for (int i = 0; i < qsize; i++)
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: LOTTERY] Selected process %d (ticket %lld of %lld, holds %lld)\n",
+                selected_pid, winner, total, PCB_OF(ctx, selected_pid)->lottery_tickets);
+    return selected_pid;
+}
+
+// Stride Algorithm --> Smallest pass first
+int scissos_schedule_stride(ScisSosContext *ctx)
+{
+    if (ctx->rq->ready_heap.size == 0)
     {
-        int index = (start_index + i) % qsize;
+        return EMPTY;
+    }
+
+    int selected_pid = scissos_heap_top(&ctx->rq->ready_heap);
+
+    SCISSOS_LOG(ctx, LOG_DECISIONS, "[SCHEDULER: STRIDE] Selected process %d (pass=%lld, tickets=%d)\n",
+                selected_pid, ctx->rq->ready_heap.nodes[0].key, PCB_OF(ctx, selected_pid)->tickets);
+    return selected_pid;
+}
+
+/** Real-time task as seen by the schedulability tests **/
+typedef struct
+{
+    long long wcet, deadline, period;
+    int pid;
+} ScisSosRtTask;
+
+// qsort comparator: rate-monotonic priority order
+static int scissos_cmp_rate(const void *a, const void *b)
+{
+    const ScisSosRtTask *x = (const ScisSosRtTask *)a, *y = (const ScisSosRtTask *)b;
+    if (x->period != y->period)
+    {
+        return x->period < y->period ? -1 : 1;
+    }
+    return (x->pid > y->pid) - (x->pid < y->pid);
+}
 
-        if (readyQ[index] != EMPTY)
+// Exact rate-monotonic test: the worst-case response time of every task, released together
+// with all higher-priority tasks, must fit within its deadline
+static int scissos_rm_response_time(ScisSosRtTask *tasks, int n)
+{
+    qsort(tasks, n, sizeof(ScisSosRtTask), scissos_cmp_rate);
+
+    for (int i = 0; i < n; i++)
+    {
+        long long response = tasks[i].wcet, next;
+        for (int j = 0; j < i; j++)
         {
-            int pid = readyQ[index];
+            response += tasks[j].wcet;
+        }
 
-            // Validate PID
-            if (pid >= 1 && pid <= MAXPROC && _proctable[pid - 1] != NULL)
+        while (response <= tasks[i].deadline)
+        {
+            next = tasks[i].wcet;
+            for (int j = 0; j < i; j++)
             {
-                selected_pid = pid;
-                last_scheduled_index = index; // Update last scheduled index
-                fprintf(stdout, "[SCHEDULER: ROUND ROBIN] Selected process %d (position %d in queue)\n",
-                        selected_pid, index);
-                return selected_pid;
+                next += (response + tasks[j].period - 1) / tasks[j].period * tasks[j].wcet;
             }
-            else
+            if (next == response)
             {
-                fprintf(stderr, "Warning: Invalid PID %d at index %d in ready queue\n", pid, index);
+                break;
             }
+            response = next;
         }
+
+        if (response > tasks[i].deadline)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Report whether the admitted real-time processes are schedulable under EDF and RM.
+// Returns 1 if they are under RM, 0 if not, -1 if too many to tell. Both tests assume
+// preemption at release; the simulator only switches at quantum ends and long syscalls.
+int scissos_rt_check(ScisSosContext *ctx, FILE *out)
+{
+    int n = ctx->rt_count;
+    if (n == 0)
+    {
+        return 1;
     }
 
-    // No valid process found - reset index
-    last_scheduled_index = -1;
-    return EMPTY;
-}
\ No newline at end of file
+    double bound = n * (pow(2.0, 1.0 / n) - 1.0);
+    fprintf(out, "Real-time processes: %d, utilisation %.3f, density %.3f\n", n, ctx->rt_util, ctx->rt_density);
+    fprintf(out, "EDF: schedulable (density <= 1 on admission)\n");
+
+    int implicit = 1;
+    for (int i = 0; i < ctx->slot_high && implicit; i++)
+    {
+        const ScisSosPCB *pcb = ctx->proctable[i];
+        implicit = pcb == NULL || pcb->period == 0 || pcb->rel_deadline == pcb->period;
+    }
+    if (implicit && ctx->rt_util <= bound)
+    {
+        fprintf(out, "RM: schedulable (utilisation <= Liu-Layland bound %.3f)\n", bound);
+        return 1;
+    }
+    if (n > RT_RTA_MAX)
+    {
+        fprintf(out, "RM: unknown (above the utilisation bound, too many tasks for response-time analysis)\n");
+        return -1;
+    }
+
+    ScisSosRtTask *tasks = (ScisSosRtTask *)malloc(n * sizeof(ScisSosRtTask));
+    if (!tasks)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for schedulability test.\n");
+        return -1;
+    }
+    int count = 0;
+    for (int i = 0; i < ctx->slot_high && count < n; i++)
+    {
+        const ScisSosPCB *pcb = ctx->proctable[i];
+        if (pcb != NULL && pcb->period > 0)
+        {
+            ScisSosRtTask task = {pcb->wcet, pcb->rel_deadline, pcb->period, pcb->pid};
+            tasks[count++] = task;
+        }
+    }
+
+    int schedulable = scissos_rm_response_time(tasks, count);
+    fprintf(out, "RM: %s (response-time analysis)\n", schedulable ? "schedulable" : "NOT schedulable");
+    free(tasks);
+    return schedulable;
+}
+
+/** Registered scheduling policies **/
+static const ScisSosPolicy policies[] = {
+    {"fcfs", scissos_schedule_fcfs, NULL, NULL, NULL, NULL, NULL, NULL, 0},
+    {"sjf", scissos_schedule_sjf, scissos_sjf_on_ready, scissos_heap_on_unready, NULL, NULL, NULL, NULL, 0},
+    {"priority", scissos_schedule_priority, scissos_priority_on_ready, scissos_heap_on_unready,
+     scissos_priority_on_update, NULL, NULL, NULL, 0},
+    {"rr", scissos_schedule_rr, NULL, NULL, NULL, NULL, NULL, NULL, 1},
+    {"mlfq", scissos_schedule_mlfq, scissos_mlfq_on_ready, scissos_mlfq_on_unready, NULL,
+     scissos_mlfq_on_expire, scissos_mlfq_on_block, NULL, 1},
+    {"cfs", scissos_schedule_cfs, scissos_cfs_on_ready, scissos_cfs_on_unready, scissos_cfs_on_update,
+     NULL, NULL, scissos_cfs_on_charge, 1},
+    {"fshare", scissos_schedule_fshare, scissos_fshare_rr_on_ready, scissos_fshare_on_unready, NULL,
+     NULL, NULL, scissos_fshare_on_charge, 1},
+    {"fshare-sjf", scissos_schedule_fshare, scissos_fshare_sjf_on_ready, scissos_fshare_on_unready, NULL,
+     NULL, NULL, scissos_fshare_on_charge, 1},
+    {"fshare-priority", scissos_schedule_fshare, scissos_fshare_priority_on_ready, scissos_fshare_on_unready,
+     scissos_fshare_priority_on_update, NULL, NULL, scissos_fshare_on_charge, 1},
+    {"edf", scissos_schedule_edf, scissos_edf_on_ready, scissos_heap_on_unready, scissos_edf_on_update,
+     NULL, NULL, NULL, 1},
+    {"rm", scissos_schedule_rm, scissos_rm_on_ready, scissos_heap_on_unready, scissos_rm_on_update,
+     NULL, NULL, NULL, 1},
+    {"lottery", scissos_schedule_lottery, scissos_lottery_on_ready, scissos_lottery_on_unready,
+     scissos_lottery_on_update, NULL, NULL, scissos_lottery_on_charge, 1},
+    {"stride", scissos_schedule_stride, scissos_stride_on_ready, scissos_heap_on_unready, NULL,
+     NULL, NULL, scissos_stride_on_charge, 1},
+};
+
+#define NUM_POLICIES (int)(sizeof(policies) / sizeof(policies[0]))
+
+// Look up a scheduling policy by name
+const ScisSosPolicy *scissos_find_policy(const char *name)
+{
+    for (int i = 0; i < NUM_POLICIES; i++)
+    {
+        if (strcmp(policies[i].name, name) == 0)
+        {
+            return &policies[i];
+        }
+    }
+    return NULL;
+}
+
+// Print the names of all available policies
+void scissos_print_policies(FILE *out)
+{
+    fprintf(out, "Available schedulers: ");
+    for (int i = 0; i < NUM_POLICIES; i++)
+    {
+        fprintf(out, "%s%s", i ? ", " : "", policies[i].name);
+    }
+    fprintf(out, "\n");
+}
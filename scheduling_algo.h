@@ -3,10 +3,57 @@
 
 #include "ScisSos.h"
 
+/** Scheduling policy; hooks keep the policy's own ready structure in sync **/
+typedef struct ScisSosPolicy
+{
+    const char *name;                                      /* Name used to select the policy */
+    int (*pick)(ScisSosContext *ctx);                      /* Select next PID, EMPTY if none */
+    int (*on_ready)(ScisSosContext *ctx, ScisSosPCB *pcb);    /* Process joined the ready queue; -1 if out of memory */
+    void (*on_unready)(ScisSosContext *ctx, ScisSosPCB *pcb); /* Process left the ready queue */
+    void (*on_update)(ScisSosContext *ctx, ScisSosPCB *pcb);  /* Ready process changed its key */
+    void (*on_expire)(ScisSosContext *ctx, ScisSosPCB *pcb);  /* Running process used up its quantum */
+    void (*on_block)(ScisSosContext *ctx, ScisSosPCB *pcb);   /* Running process blocked on a long syscall */
+    void (*on_charge)(ScisSosContext *ctx, ScisSosPCB *pcb, int ticks); /* Running process used ticks of CPU */
+    int requeue_tail;                                      /* Preempted process goes to the back */
+} ScisSosPolicy;
+
 // All Scheduling Algos
-int scissos_schedule_fcfs(int *readyQ, int qsize);     /* First Come First Serve */
-int scissos_schedule_sjf(int *readyQ, int qsize);      /* Shortest Job First */
-int scissos_schedule_priority(int *readyQ, int qsize); /* Priority */
-int scissos_schedule_rr(int *readyQ, int qsize);       /* Round Robin */
+int scissos_schedule_fcfs(ScisSosContext *ctx);     /* First Come First Serve */
+int scissos_schedule_sjf(ScisSosContext *ctx);      /* Shortest Job First */
+int scissos_schedule_priority(ScisSosContext *ctx); /* Priority */
+int scissos_schedule_rr(ScisSosContext *ctx);       /* Round Robin */
+int scissos_schedule_mlfq(ScisSosContext *ctx);     /* Multi-Level Feedback Queue */
+int scissos_schedule_cfs(ScisSosContext *ctx);      /* Completely Fair Scheduler */
+int scissos_schedule_fshare(ScisSosContext *ctx);   /* Per-user Fair Share */
+int scissos_schedule_edf(ScisSosContext *ctx);      /* Earliest Deadline First */
+int scissos_schedule_rm(ScisSosContext *ctx);       /* Rate Monotonic */
+int scissos_schedule_lottery(ScisSosContext *ctx);  /* Lottery */
+int scissos_schedule_stride(ScisSosContext *ctx);   /* Stride */
+
+const ScisSosPolicy *scissos_find_policy(const char *name); /* Look up a policy by name */
+void scissos_print_policies(FILE *out);                     /* List available policies */
+int scissos_rt_check(ScisSosContext *ctx, FILE *out);       /* Report EDF and RM schedulability */
+int scissos_priority_weight(int priority);                  /* CFS weight and share tickets of a priority */
+
+/** Indexed min-heap found in heap.c file, O(log n) updates **/
+void scissos_heap_init(ScisSosHeap *heap);                                 /* Initialise empty heap */
+void scissos_heap_free(ScisSosHeap *heap);                                 /* Release heap storage */
+int scissos_heap_push(ScisSosHeap *heap, ScisSosPCB *pcb, long long key);  /* Insert process */
+void scissos_heap_remove(ScisSosHeap *heap, ScisSosPCB *pcb);              /* Remove process */
+void scissos_heap_update(ScisSosHeap *heap, ScisSosPCB *pcb, long long key); /* Change key */
+int scissos_heap_top(const ScisSosHeap *heap);                             /* PID with smallest key */
+
+/** Red-black tree found in rbtree.c file, O(log n) updates and O(1) minimum **/
+void scissos_rb_init(ScisSosRbTree *tree);                                               /* Initialise empty tree */
+void scissos_rb_insert(ScisSosRbTree *tree, ScisSosRbNode *node, long long key, int id); /* Insert node */
+void scissos_rb_remove(ScisSosRbTree *tree, ScisSosRbNode *node);                        /* Remove node */
+int scissos_rb_first(const ScisSosRbTree *tree);                                         /* ID with smallest key */
+
+/** Fenwick tree found in fenwick.c file, O(log n) updates and searches **/
+void scissos_fenwick_init(ScisSosFenwick *tree);                              /* Initialise empty tree */
+void scissos_fenwick_free(ScisSosFenwick *tree);                              /* Release tree storage */
+int scissos_fenwick_add(ScisSosFenwick *tree, int index, long long delta);    /* Add to one value */
+long long scissos_fenwick_get(const ScisSosFenwick *tree, int index);         /* One value */
+int scissos_fenwick_find(const ScisSosFenwick *tree, long long target);       /* Index holding a cumulative position */
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,532 @@
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ScisSos.h"
+#include "scheduling_algo.h"
+
+#define MAX_ITEMS 16   /* Max values per grid axis */
+#define MAX_THREADS 256
+#define DEF_SEEDS 10   /* Default seeds per configuration */
+#define DEF_PSIZE 5000 /* Default mean instructions per process */
+#define NUM_FIELDS 14  /* Figures recorded per run */
+
+/** One point of the grid: everything but the seed **/
+typedef struct
+{
+    const char *policy;
+    int nproc;
+    int timeslice;
+    const char *mix;
+    int type_weight[3];
+    int ncpu;
+    const char *quantum;
+} SweepConfig;
+
+/** One simulation: a configuration and a seed, plus its results **/
+typedef struct
+{
+    int config;                /* Index into the configuration table */
+    unsigned int seed;
+    int ok;                    /* Set once the run completed */
+    double fields[NUM_FIELDS]; /* See field_names */
+} SweepJob;
+
+/** Per-worker deque of job indices; the owner pops the bottom, thieves take the top **/
+typedef struct
+{
+    pthread_mutex_t lock;
+    int *jobs;
+    int top;
+    int bottom;
+} SweepDeque;
+
+static const char *field_names[NUM_FIELDS] = {"dispatches", "turnaround", "waiting", "response",
+                                              "makespan", "utilisation", "throughput", "wall_ms",
+                                              "deadline_miss_pct", "lateness", "share_error",
+                                              "migrations", "preemptions", "latency"};
+
+static const char *default_policies = "fcfs,sjf,priority,rr";
+static const char *default_sizes = "100";
+static const char *default_slices = "6239";
+static const char *default_mixes = "1/1/1";
+static const char *default_cpus = "1";
+static const char *default_quanta = "fixed";
+
+static SweepConfig *configs;
+static SweepJob *jobs;
+static SweepDeque *deques;
+static int nthreads;
+static int psize = DEF_PSIZE;
+static const char *io_latency = NULL;
+static int rt_tasks = 0;      /* Periodic processes per workload */
+static double rt_util = 0.0;  /* Their total utilisation */
+static long long migration_cost = 0; /* Ticks per migration on multi-CPU runs */
+
+// Seconds on the monotonic clock
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Split a comma separated list in place
+static int split_list(char *list, char *items[], int max)
+{
+    int n = 0;
+    for (char *tok = strtok(list, ","); tok != NULL && n < max; tok = strtok(NULL, ","))
+    {
+        items[n++] = tok;
+    }
+    return n;
+}
+
+// Run one simulation in a private context and record its figures
+static void run_job(SweepJob *job)
+{
+    const SweepConfig *cfg = &configs[job->config];
+    ScisSosContext *ctx = scissos_context_create();
+    if (ctx == NULL)
+    {
+        return;
+    }
+
+    scissos_set_log_level(ctx, LOG_OFF);
+    scissos_initialise(ctx);
+    scissos_set_reap(ctx, 1);
+    scissos_set_cpus(ctx, cfg->ncpu);
+    scissos_set_migration_cost(ctx, migration_cost);
+    scissos_parse_quantum(ctx, cfg->quantum);
+    scissos_seed(ctx, job->seed);
+    if (io_latency != NULL)
+    {
+        scissos_parse_io_latency(ctx, io_latency);
+    }
+
+    ScisSosWorkloadSpec spec = {cfg->nproc, psize,
+                                {cfg->type_weight[0], cfg->type_weight[1], cfg->type_weight[2]},
+                                2 * DEFPRIO, 1, rt_tasks, rt_util};
+
+    if (scissos_set_timeslice(ctx, cfg->timeslice) == 0 &&
+        scissos_workload_create(ctx, &spec) >= 0 &&
+        scissos_set_scheduler(ctx, cfg->policy) == 0)
+    {
+        double start = now();
+        long dispatches = scissos_run_dispatcher(ctx);
+        double wall = now() - start;
+
+        ScisSosRunSummary sum;
+        scissos_metrics_summary(ctx, &sum);
+
+        job->fields[0] = (double)dispatches;
+        job->fields[1] = sum.turnaround;
+        job->fields[2] = sum.waiting;
+        job->fields[3] = sum.response;
+        job->fields[4] = (double)sum.makespan;
+        job->fields[5] = sum.utilisation;
+        job->fields[6] = sum.throughput;
+        job->fields[7] = wall * 1e3;
+        job->fields[8] = sum.jobs > 0 ? 100.0 * sum.misses / sum.jobs : 0.0;
+        job->fields[9] = sum.lateness;
+        job->fields[10] = sum.share_error;
+        job->fields[11] = (double)sum.migrations;
+        job->fields[12] = (double)sum.preemptions;
+        job->fields[13] = sum.latency;
+        job->ok = dispatches >= 0; // a run that stopped early is left out of the means
+    }
+
+    scissos_context_destroy(ctx);
+}
+
+// Take a job from the bottom of the worker's own deque, EMPTY if none
+static int deque_pop(SweepDeque *d)
+{
+    int job = EMPTY;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top)
+    {
+        job = d->jobs[--d->bottom];
+    }
+    pthread_mutex_unlock(&d->lock);
+
+    return job;
+}
+
+// Take a job from the top of another worker's deque, EMPTY if none
+static int deque_steal(SweepDeque *d)
+{
+    int job = EMPTY;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top)
+    {
+        job = d->jobs[d->top++];
+    }
+    pthread_mutex_unlock(&d->lock);
+
+    return job;
+}
+
+// Worker: drain the own deque, then steal until every deque is empty
+static void *worker(void *arg)
+{
+    int self = (int)(long)arg;
+
+    for (;;)
+    {
+        int job = deque_pop(&deques[self]);
+
+        // Own work exhausted: scan the others, starting after ourselves
+        for (int i = 1; job == EMPTY && i < nthreads; i++)
+        {
+            job = deque_steal(&deques[(self + i) % nthreads]);
+        }
+
+        // No job is ever added after start-up, so an empty scan means done
+        if (job == EMPTY)
+        {
+            return NULL;
+        }
+        run_job(&jobs[job]);
+    }
+}
+
+// Two-sided 95% Student t critical value for the given degrees of freedom
+static double t95(int df)
+{
+    static const double table[] = {0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+                                   2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+                                   2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+                                   2.042};
+
+    if (df < 1)
+    {
+        return 0.0;
+    }
+    return df <= 30 ? table[df] : 1.960;
+}
+
+// Mean and 95% confidence half-width of one field over the runs of a configuration
+static void aggregate(int config, int njobs, int field, int *runs, double *mean, double *ci)
+{
+    double sum = 0.0, sq = 0.0;
+    int n = 0;
+
+    for (int i = 0; i < njobs; i++)
+    {
+        if (jobs[i].config == config && jobs[i].ok)
+        {
+            sum += jobs[i].fields[field];
+            n++;
+        }
+    }
+
+    *mean = n > 0 ? sum / n : 0.0;
+    for (int i = 0; i < njobs; i++)
+    {
+        if (jobs[i].config == config && jobs[i].ok)
+        {
+            sq += (jobs[i].fields[field] - *mean) * (jobs[i].fields[field] - *mean);
+        }
+    }
+
+    *runs = n;
+    *ci = n > 1 ? t95(n - 1) * sqrt(sq / (n - 1)) / sqrt(n) : 0.0;
+}
+
+// Write one row per configuration as CSV
+static void write_csv(FILE *out, int nconfigs, int njobs)
+{
+    fprintf(out, "policy,procs,timeslice,mix,cpus,quantum,runs");
+    for (int f = 0; f < NUM_FIELDS; f++)
+    {
+        fprintf(out, ",%s,%s_ci95", field_names[f], field_names[f]);
+    }
+    fprintf(out, "\n");
+
+    for (int c = 0; c < nconfigs; c++)
+    {
+        const SweepConfig *cfg = &configs[c];
+        int runs;
+        double mean, ci;
+
+        aggregate(c, njobs, 0, &runs, &mean, &ci);
+        fprintf(out, "%s,%d,%d,%s,%d,%s,%d", cfg->policy, cfg->nproc, cfg->timeslice, cfg->mix, cfg->ncpu,
+                cfg->quantum, runs);
+        for (int f = 0; f < NUM_FIELDS; f++)
+        {
+            aggregate(c, njobs, f, &runs, &mean, &ci);
+            fprintf(out, ",%.6g,%.6g", mean, ci);
+        }
+        fprintf(out, "\n");
+    }
+}
+
+// Write the configurations as a JSON array
+static void write_json(FILE *out, int nconfigs, int njobs)
+{
+    fprintf(out, "[\n");
+    for (int c = 0; c < nconfigs; c++)
+    {
+        const SweepConfig *cfg = &configs[c];
+        int runs;
+        double mean, ci;
+
+        aggregate(c, njobs, 0, &runs, &mean, &ci);
+        fprintf(out, "  {\"policy\": \"%s\", \"procs\": %d, \"timeslice\": %d, \"mix\": \"%s\", \"cpus\": %d, \"quantum\": \"%s\", \"runs\": %d",
+                cfg->policy, cfg->nproc, cfg->timeslice, cfg->mix, cfg->ncpu, cfg->quantum, runs);
+        for (int f = 0; f < NUM_FIELDS; f++)
+        {
+            aggregate(c, njobs, f, &runs, &mean, &ci);
+            fprintf(out, ", \"%s\": {\"mean\": %.6g, \"ci95\": %.6g}", field_names[f], mean, ci);
+        }
+        fprintf(out, "}%s\n", c + 1 < nconfigs ? "," : "");
+    }
+    fprintf(out, "]\n");
+}
+
+// Print command line usage
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-p policies] [-n process_counts] [-t timeslices] [-x mixes] [-c cpu_counts] [-Q quanta]\n"
+                    "       [-S seeds] [-s first_seed] [-z instructions] [-L io_latency] [-R tasks:util]\n"
+                    "       [-M migration_cost] [-j threads] [-f csv|json] [-o output]\n",
+            prog);
+    fprintf(stderr, "  defaults: -p %s -n %s -t %s -x %s -c %s -Q %s -S %d -z %d -j <online cpus> -f csv\n",
+            default_policies, default_sizes, default_slices, default_mixes, default_cpus, default_quanta, DEF_SEEDS,
+            DEF_PSIZE);
+    fprintf(stderr, "  a mix R/C/I weights regular, compute-intensive and I/O-intensive processes\n");
+    fprintf(stderr, "  a quantum is a time-slice controller: fixed, adaptive or adaptive:N\n");
+}
+
+int main(int argc, char *argv[])
+{
+    char policy_list[256], size_list[256], slice_list[256], mix_list[256], cpu_list[256], quantum_list[256];
+    char *policies[MAX_ITEMS], *sizes[MAX_ITEMS], *slices[MAX_ITEMS], *mixes[MAX_ITEMS], *cpus[MAX_ITEMS];
+    char *quanta[MAX_ITEMS];
+    int nseeds = DEF_SEEDS, json = 0;
+    unsigned int first_seed = 1;
+    const char *output = NULL;
+    int opt;
+
+    nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    snprintf(policy_list, sizeof(policy_list), "%s", default_policies);
+    snprintf(size_list, sizeof(size_list), "%s", default_sizes);
+    snprintf(slice_list, sizeof(slice_list), "%s", default_slices);
+    snprintf(mix_list, sizeof(mix_list), "%s", default_mixes);
+    snprintf(cpu_list, sizeof(cpu_list), "%s", default_cpus);
+    snprintf(quantum_list, sizeof(quantum_list), "%s", default_quanta);
+
+    while ((opt = getopt(argc, argv, "p:n:t:x:c:Q:S:s:z:L:R:M:j:f:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            snprintf(policy_list, sizeof(policy_list), "%s", optarg);
+            break;
+        case 'n':
+            snprintf(size_list, sizeof(size_list), "%s", optarg);
+            break;
+        case 't':
+            snprintf(slice_list, sizeof(slice_list), "%s", optarg);
+            break;
+        case 'x':
+            snprintf(mix_list, sizeof(mix_list), "%s", optarg);
+            break;
+        case 'c':
+            snprintf(cpu_list, sizeof(cpu_list), "%s", optarg);
+            break;
+        case 'Q':
+            snprintf(quantum_list, sizeof(quantum_list), "%s", optarg);
+            break;
+        case 'S':
+            nseeds = atoi(optarg);
+            break;
+        case 's':
+            first_seed = (unsigned int)strtoul(optarg, NULL, 10);
+            break;
+        case 'z':
+            psize = atoi(optarg);
+            break;
+        case 'L':
+            io_latency = optarg;
+            break;
+        case 'R':
+            if (scissos_parse_rt(optarg, &rt_tasks, &rt_util) != 0)
+            {
+                return 1;
+            }
+            break;
+        case 'M':
+            migration_cost = strtoll(optarg, NULL, 10);
+            break;
+        case 'j':
+            nthreads = atoi(optarg);
+            break;
+        case 'f':
+            if (strcmp(optarg, "json") != 0 && strcmp(optarg, "csv") != 0)
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            json = strcmp(optarg, "json") == 0;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (nseeds < 1 || psize < 1 || nthreads < 1 || migration_cost < 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if (nthreads > MAX_THREADS)
+    {
+        nthreads = MAX_THREADS;
+    }
+
+    int npolicies = split_list(policy_list, policies, MAX_ITEMS);
+    int nsizes = split_list(size_list, sizes, MAX_ITEMS);
+    int nslices = split_list(slice_list, slices, MAX_ITEMS);
+    int nmixes = split_list(mix_list, mixes, MAX_ITEMS);
+    int ncpus = split_list(cpu_list, cpus, MAX_ITEMS);
+    int nquanta = split_list(quantum_list, quanta, MAX_ITEMS);
+
+    // Reject a bad latency or controller spec before any run starts
+    ScisSosContext *probe = scissos_context_create();
+    int bad_spec = probe == NULL || (io_latency != NULL && scissos_parse_io_latency(probe, io_latency) != 0);
+    for (int q = 0; q < nquanta && !bad_spec; q++)
+    {
+        bad_spec = scissos_parse_quantum(probe, quanta[q]) != 0;
+    }
+    scissos_context_destroy(probe);
+    if (bad_spec)
+    {
+        return 1;
+    }
+
+    // Expand the grid
+    int nconfigs = npolicies * nsizes * nslices * nmixes * ncpus * nquanta;
+    int njobs = nconfigs * nseeds;
+    configs = (SweepConfig *)calloc(nconfigs, sizeof(SweepConfig));
+    jobs = (SweepJob *)calloc(njobs, sizeof(SweepJob));
+    deques = (SweepDeque *)calloc(nthreads, sizeof(SweepDeque));
+    pthread_t *threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+    if (!configs || !jobs || !deques || !threads)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for sweep.\n");
+        return 1;
+    }
+
+    int c = 0;
+    for (int p = 0; p < npolicies; p++)
+    {
+        if (scissos_find_policy(policies[p]) == NULL)
+        {
+            fprintf(stderr, "Error: Unknown scheduler '%s'\n", policies[p]);
+            scissos_print_policies(stderr);
+            return 1;
+        }
+        for (int n = 0; n < nsizes; n++)
+        {
+            for (int t = 0; t < nslices; t++)
+            {
+                for (int m = 0; m < nmixes; m++)
+                {
+                    for (int k = 0; k < ncpus; k++)
+                    {
+                        for (int q = 0; q < nquanta; q++, c++)
+                        {
+                            configs[c].policy = policies[p];
+                            configs[c].nproc = atoi(sizes[n]);
+                            configs[c].timeslice = atoi(slices[t]);
+                            configs[c].mix = mixes[m];
+                            configs[c].ncpu = atoi(cpus[k]);
+                            configs[c].quantum = quanta[q];
+                            if (configs[c].nproc < 1 || configs[c].nproc > PID_SLOT_MASK || configs[c].timeslice < 1 ||
+                                configs[c].ncpu < 1 || configs[c].ncpu > MAXCPUS ||
+                                scissos_parse_mix(mixes[m], configs[c].type_weight) != 0)
+                            {
+                                fprintf(stderr, "Error: Invalid grid point %s/%s/%s/%s/%s/%s\n",
+                                        policies[p], sizes[n], slices[t], mixes[m], cpus[k], quanta[q]);
+                                return 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Deal the jobs round robin so every worker starts with a similar mix
+    for (int d = 0; d < nthreads; d++)
+    {
+        pthread_mutex_init(&deques[d].lock, NULL);
+        deques[d].jobs = (int *)malloc((njobs / nthreads + 1) * sizeof(int));
+        if (!deques[d].jobs)
+        {
+            fprintf(stderr, "Error: Memory allocation failed for sweep.\n");
+            return 1;
+        }
+    }
+    for (int j = 0; j < njobs; j++)
+    {
+        SweepDeque *d = &deques[j % nthreads];
+        jobs[j].config = j / nseeds;
+        jobs[j].seed = first_seed + (unsigned int)(j % nseeds);
+        d->jobs[d->bottom++] = j;
+    }
+
+    double start = now();
+    for (int t = 0; t < nthreads; t++)
+    {
+        pthread_create(&threads[t], NULL, worker, (void *)(long)t);
+    }
+    for (int t = 0; t < nthreads; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+    fprintf(stderr, "Swept %d configurations x %d seeds on %d threads in %.2f s\n",
+            nconfigs, nseeds, nthreads, now() - start);
+
+    FILE *out = output != NULL ? fopen(output, "w") : stdout;
+    if (out == NULL)
+    {
+        fprintf(stderr, "Error: Cannot write results to '%s'\n", output);
+        return 1;
+    }
+    if (json)
+    {
+        write_json(out, nconfigs, njobs);
+    }
+    else
+    {
+        write_csv(out, nconfigs, njobs);
+    }
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    for (int d = 0; d < nthreads; d++)
+    {
+        pthread_mutex_destroy(&deques[d].lock);
+        free(deques[d].jobs);
+    }
+    free(threads);
+    free(deques);
+    free(jobs);
+    free(configs);
+    return 0;
+}
@@ -1,101 +1,331 @@
 #define _POSIX_C_SOURCE 199309L
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
-#include <sys/wait.h>
-#include <fcntl.h>
+#include "ScisSos.h"
+#include "scheduling_algo.h"
 
-#define ALGO_COUNT 4
-#define NUM_RUNS 10
+#define MAX_ITEMS 16   /* Max policies / workload sizes per benchmark */
+#define DEF_WARMUP 2   /* Default warmup runs per configuration */
+#define DEF_REPS 20    /* Default measured runs per configuration */
+#define DEF_PSIZE 5000 /* Default mean instructions per process */
 
-const char *algorithms[ALGO_COUNT] = {"fcfs", "sjf", "priority", "rr"};
+/** One measured run **/
+typedef struct
+{
+    double wall; /* Wall-clock seconds in the dispatch loop */
+    double cpu;  /* CPU seconds in the dispatch loop */
+    long dispatches;
+} BenchSample;
+
+/** Summary statistics over the measured runs **/
+typedef struct
+{
+    double mean, median, p95, p99, stddev;
+} BenchStats;
+
+static const char *default_policies = "fcfs,sjf,priority,rr";
+static const char *default_sizes = "10,100,1000";
+static int show_quality = 0;          /* Print scheduling metrics of each configuration */
+static const char *io_latency = NULL; /* I/O latency applied to every simulation */
+static int build_threads = 1;         /* Threads building each workload */
+static int lazy_code = 0;             /* Generate code in windows as it runs */
+static int rt_tasks = 0;              /* Periodic processes per workload */
+static double rt_util = 0.0;          /* Their total utilisation */
+static int ncpu = 1;                  /* Simulated CPUs */
+static long long migration_cost = 0;  /* Ticks lost per migration */
+static const char *quantum = NULL;    /* Time-slice controller applied to every simulation */
+
+// Seconds on the given clock
+static double now(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
 
-double run_once(const char *algo)
+// qsort comparator for doubles
+static int cmp_double(const void *a, const void *b)
 {
-    struct timespec start;
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
 
-    pid_t pid = fork();
-    if (pid == 0)
+// Compute mean, median, p95, p99 and standard deviation
+static BenchStats summarise(double *values, int n)
+{
+    BenchStats s = {0, 0, 0, 0, 0};
+    if (n <= 0)
     {
-        // Child: suppress output
-        int devnull = open("/dev/null", O_WRONLY);
-        if (devnull == -1)
-        {
-            perror("open /dev/null failed");
-            exit(1);
-        }
-        dup2(devnull, STDOUT_FILENO);
-        dup2(devnull, STDERR_FILENO);
-        close(devnull);
+        return s;
+    }
 
-        // Measure child process CPU time only
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &start);
+    qsort(values, n, sizeof(double), cmp_double);
 
-        execl("./run_os", "run_os", algo, (char *)NULL);
-        perror("execl failed");
-        exit(1);
+    for (int i = 0; i < n; i++)
+    {
+        s.mean += values[i];
     }
-    else if (pid > 0)
+    s.mean /= n;
+
+    for (int i = 0; i < n; i++)
     {
-        // Parent: wait for child to finish
-        int status;
-        struct timespec usage_start, usage_end;
+        s.stddev += (values[i] - s.mean) * (values[i] - s.mean);
+    }
+    s.stddev = n > 1 ? sqrt(s.stddev / (n - 1)) : 0.0;
 
-        // Measure CPU time of child using /proc after it exits
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &usage_start);
-        waitpid(pid, &status, 0);
-        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &usage_end);
+    s.median = n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+    s.p95 = scissos_percentile(values, n, 95);
+    s.p99 = scissos_percentile(values, n, 99);
 
-        double cpu_time = (usage_end.tv_sec - usage_start.tv_sec) +
-                          (usage_end.tv_nsec - usage_start.tv_nsec) / 1e9;
+    return s;
+}
 
-        return cpu_time;
+// Split a comma separated list in place
+static int split_list(char *list, char *items[], int max)
+{
+    int n = 0;
+    for (char *tok = strtok(list, ","); tok != NULL && n < max; tok = strtok(NULL, ","))
+    {
+        items[n++] = tok;
     }
-    else
+    return n;
+}
+
+// Build a fresh workload of nproc processes and time one full dispatch run
+static int run_once(ScisSosContext *ctx, const char *policy, int nproc, int psize, unsigned int seed,
+                    BenchSample *sample)
+{
+    scissos_initialise(ctx);
+    scissos_set_reap(ctx, 1);
+    scissos_seed(ctx, seed); // identical workload for every policy and repetition
+
+    ScisSosWorkloadSpec spec = {nproc, psize, {1, 1, 1}, 2 * DEFPRIO, build_threads, rt_tasks, rt_util};
+    if (scissos_workload_create(ctx, &spec) < 0)
     {
-        perror("fork failed");
-        return -1.0;
+        scissos_shutdown(ctx);
+        return -1;
     }
+
+    if (scissos_set_scheduler(ctx, policy) != 0)
+    {
+        scissos_shutdown(ctx);
+        return -1;
+    }
+
+    double wall_start = now(CLOCK_MONOTONIC);
+    double cpu_start = now(CLOCK_PROCESS_CPUTIME_ID);
+
+    sample->dispatches = scissos_run_dispatcher(ctx);
+
+    sample->cpu = now(CLOCK_PROCESS_CPUTIME_ID) - cpu_start;
+    sample->wall = now(CLOCK_MONOTONIC) - wall_start;
+
+    scissos_shutdown(ctx);
+    return sample->dispatches < 0 ? -1 : 0;
 }
 
-void benchmark_algorithm(const char *algo)
+// Run warmups and repetitions for one configuration and print its statistics
+static void benchmark(const char *policy, int nproc, int psize, int warmup, int reps, unsigned int seed)
 {
-    double total = 0.0, min = 1e9, max = 0.0;
-    double time;
+    BenchSample sample;
+    double *wall = malloc(reps * sizeof(double));
+    double *cpu = malloc(reps * sizeof(double));
+    double *rate = malloc(reps * sizeof(double));
+    ScisSosContext *ctx = scissos_context_create();
+    int n = 0;
+
+    if (!wall || !cpu || !rate || !ctx)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for samples.\n");
+        free(wall);
+        free(cpu);
+        free(rate);
+        scissos_context_destroy(ctx);
+        return;
+    }
+
+    // The simulator must stay silent so only the engine is measured
+    scissos_set_log_level(ctx, LOG_OFF);
+    scissos_set_lazy_code(ctx, lazy_code);
+    scissos_set_cpus(ctx, ncpu);
+    scissos_set_migration_cost(ctx, migration_cost);
+    if (io_latency != NULL)
+    {
+        scissos_parse_io_latency(ctx, io_latency);
+    }
+    if (quantum != NULL)
+    {
+        scissos_parse_quantum(ctx, quantum);
+    }
 
-    fprintf(stdout, "Benchmarking (CPU Time): %s\n", algo);
+    for (int i = 0; i < warmup; i++)
+    {
+        run_once(ctx, policy, nproc, psize, seed, &sample);
+    }
 
-    for (int i = 0; i < NUM_RUNS; i++)
+    for (int i = 0; i < reps; i++)
     {
-        time = run_once(algo);
-        if (time < 0)
+        if (run_once(ctx, policy, nproc, psize, seed, &sample) != 0)
         {
-            fprintf(stderr, "Error in run #%d for %s\n", i + 1, algo);
+            fprintf(stderr, "Error in run #%d for %s\n", i + 1, policy);
             continue;
         }
-        total += time;
-        if (time < min)
+        wall[n] = sample.wall * 1e6;
+        cpu[n] = sample.cpu * 1e6;
+        rate[n] = sample.wall > 0 ? sample.dispatches / sample.wall : 0.0;
+        n++;
+    }
+
+    BenchStats w = summarise(wall, n);
+    BenchStats c = summarise(cpu, n);
+    BenchStats r = summarise(rate, n);
+
+    fprintf(stdout, "%-9s %7d %9ld | wall us %10.1f %10.1f %10.1f %10.1f %9.1f | cpu us %10.1f %10.1f %10.1f %10.1f %9.1f | %12.0f\n",
+            policy, nproc, sample.dispatches,
+            w.mean, w.median, w.p95, w.p99, w.stddev,
+            c.mean, c.median, c.p95, c.p99, c.stddev, r.mean);
+
+    // Metrics of the last run are still held by the simulator
+    if (show_quality && n > 0)
+    {
+        scissos_metrics_report(ctx, stdout, policy, 0);
+        fprintf(stdout, "\n");
+    }
+    fflush(stdout);
+
+    scissos_context_destroy(ctx);
+    free(wall);
+    free(cpu);
+    free(rate);
+}
+
+// Print command line usage
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-p policies] [-n process_counts] [-z instructions] [-w warmups] [-r reps] [-s seed] [-L io_latency] [-c cpus] [-M migration_cost] [-Q fixed|adaptive[:N]] [-j build_threads] [-R tasks:util] [-g] [-q]\n", prog);
+    fprintf(stderr, "  defaults: -p %s -n %s -z %d -w %d -r %d\n",
+            default_policies, default_sizes, DEF_PSIZE, DEF_WARMUP, DEF_REPS);
+}
+
+int main(int argc, char *argv[])
+{
+    char policy_list[256], size_list[256];
+    char *policies[MAX_ITEMS], *sizes[MAX_ITEMS];
+    int warmup = DEF_WARMUP, reps = DEF_REPS, psize = DEF_PSIZE;
+    unsigned int seed = 12345;
+    int opt;
+
+    snprintf(policy_list, sizeof(policy_list), "%s", default_policies);
+    snprintf(size_list, sizeof(size_list), "%s", default_sizes);
+
+    while ((opt = getopt(argc, argv, "p:n:z:w:r:s:L:c:M:Q:j:R:gq")) != -1)
+    {
+        switch (opt)
         {
-            min = time;
+        case 'p':
+            snprintf(policy_list, sizeof(policy_list), "%s", optarg);
+            break;
+        case 'n':
+            snprintf(size_list, sizeof(size_list), "%s", optarg);
+            break;
+        case 'z':
+            psize = atoi(optarg);
+            break;
+        case 'w':
+            warmup = atoi(optarg);
+            break;
+        case 'r':
+            reps = atoi(optarg);
+            break;
+        case 's':
+            seed = (unsigned int)strtoul(optarg, NULL, 10);
+            break;
+        case 'L':
+            io_latency = optarg;
+            break;
+        case 'c':
+            ncpu = atoi(optarg);
+            break;
+        case 'M':
+            migration_cost = strtoll(optarg, NULL, 10);
+            break;
+        case 'Q':
+            quantum = optarg;
+            break;
+        case 'j':
+            build_threads = atoi(optarg);
+            break;
+        case 'R':
+            if (scissos_parse_rt(optarg, &rt_tasks, &rt_util) != 0)
+            {
+                return 1;
+            }
+            break;
+        case 'g':
+            lazy_code = 1;
+            break;
+        case 'q':
+            show_quality = 1;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
         }
-        if (time > max)
+    }
+
+    if (reps < 1 || warmup < 0 || psize < 1 || ncpu < 1 || ncpu > MAXCPUS || migration_cost < 0)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    int npolicies = split_list(policy_list, policies, MAX_ITEMS);
+    int nsizes = split_list(size_list, sizes, MAX_ITEMS);
+
+    for (int i = 0; i < npolicies; i++)
+    {
+        if (scissos_find_policy(policies[i]) == NULL)
         {
-            max = time;
+            fprintf(stderr, "Error: Unknown scheduler '%s'\n", policies[i]);
+            scissos_print_policies(stderr);
+            return 1;
         }
     }
 
-    fprintf(stdout, "→ Average CPU time: %.6f seconds (over %d runs)\n", total / NUM_RUNS, NUM_RUNS);
-    fprintf(stdout, "→ Min CPU time:     %.6f seconds\n", min);
-    fprintf(stdout, "→ Max CPU time:     %.6f seconds\n\n", max);
-}
+    // Reject a bad latency or controller spec before any run starts
+    ScisSosContext *probe = scissos_context_create();
+    int bad_spec = probe == NULL || (io_latency != NULL && scissos_parse_io_latency(probe, io_latency) != 0) ||
+                      (quantum != NULL && scissos_parse_quantum(probe, quantum) != 0);
+    scissos_context_destroy(probe);
+    if (bad_spec)
+    {
+        return 1;
+    }
 
-int main()
-{
-    for (int i = 0; i < ALGO_COUNT; i++)
+    fprintf(stdout, "ScisSOS scheduler benchmark: %d warmup + %d measured runs, ~%d instructions/process, seed %u\n\n",
+            warmup, reps, psize, seed);
+    fprintf(stdout, "%-9s %7s %9s | %-7s %10s %10s %10s %10s %9s | %-6s %10s %10s %10s %10s %9s | %12s\n",
+            "policy", "procs", "dispatch", "", "mean", "median", "p95", "p99", "stddev",
+            "", "mean", "median", "p95", "p99", "stddev", "dispatch/s");
+
+    for (int s = 0; s < nsizes; s++)
     {
-        benchmark_algorithm(algorithms[i]);
+        int nproc = atoi(sizes[s]);
+        if (nproc < 1 || nproc > PID_SLOT_MASK)
+        {
+            fprintf(stderr, "Error: Process count %s must be between 1 and %d\n", sizes[s], PID_SLOT_MASK);
+            continue;
+        }
+
+        for (int p = 0; p < npolicies; p++)
+        {
+            benchmark(policies[p], nproc, psize, warmup, reps, seed);
+        }
     }
+
     return 0;
 }
@@ -0,0 +1,111 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "ScisSos.h"
+#include "trace.h"
+
+// Start tracing into a preallocated ring, memory-mapped onto path if given
+int scissos_trace_open(ScisSosContext *ctx, const char *path, uint32_t capacity)
+{
+    if (ctx->trace_hdr != NULL)
+    {
+        scissos_trace_close(ctx);
+    }
+
+    // Round capacity up to a power of two so the ring index is a mask
+    uint32_t cap = 1;
+    while (cap < capacity && cap < (1u << 31))
+    {
+        cap <<= 1;
+    }
+
+    size_t bytes = sizeof(ScisSosTraceHeader) + (size_t)cap * sizeof(ScisSosTraceRecord);
+    void *map;
+
+    if (path != NULL)
+    {
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1)
+        {
+            fprintf(stderr, "Error: Cannot open trace file '%s'.\n", path);
+            return -1;
+        }
+        if (ftruncate(fd, (off_t)bytes) != 0)
+        {
+            fprintf(stderr, "Error: Cannot size trace file '%s'.\n", path);
+            close(fd);
+            return -1;
+        }
+        map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+    }
+    else
+    {
+        map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "Error: Memory mapping failed for trace buffer.\n");
+        return -1;
+    }
+
+    ScisSosTraceHeader *trace_hdr = (ScisSosTraceHeader *)map;
+    ctx->trace_hdr = trace_hdr;
+    ctx->trace_ring = (ScisSosTraceRecord *)(trace_hdr + 1);
+    ctx->trace_mask = cap - 1;
+    ctx->trace_bytes = bytes;
+
+    trace_hdr->magic = TRACE_MAGIC;
+    trace_hdr->version = TRACE_VERSION;
+    trace_hdr->record_size = sizeof(ScisSosTraceRecord);
+    trace_hdr->capacity = cap;
+    trace_hdr->written = 0;
+    trace_hdr->reserved = 0;
+
+    return 0;
+}
+
+// Stop tracing; a file-backed trace is written back and unmapped
+void scissos_trace_close(ScisSosContext *ctx)
+{
+    if (ctx->trace_hdr == NULL)
+    {
+        return;
+    }
+
+    msync(ctx->trace_hdr, ctx->trace_bytes, MS_SYNC);
+    munmap(ctx->trace_hdr, ctx->trace_bytes);
+
+    ctx->trace_hdr = NULL;
+    ctx->trace_ring = NULL;
+    ctx->trace_mask = 0;
+    ctx->trace_bytes = 0;
+}
+
+// Append one transition record at the current time, overwriting the oldest once the ring is full
+void scissos_trace_record(ScisSosContext *ctx, int pid, int old_state, int new_state, int pc)
+{
+    ScisSosTraceHeader *trace_hdr = ctx->trace_hdr;
+
+    if (trace_hdr == NULL)
+    {
+        return;
+    }
+
+    ScisSosTraceRecord *rec = &ctx->trace_ring[trace_hdr->written & ctx->trace_mask];
+    rec->time = ctx->clock;
+    rec->pid = pid;
+    rec->pc = pc;
+    rec->old_state = (uint8_t)old_state;
+    rec->new_state = (uint8_t)new_state;
+    memset(rec->pad, 0, sizeof(rec->pad));
+
+    trace_hdr->written++;
+}
+
+// check whether a trace is being recorded
+int scissos_trace_enabled(ScisSosContext *ctx)
+{
+    return ctx->trace_hdr != NULL;
+}
@@ -0,0 +1,45 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/****
+ *  Binary state-transition trace. A trace file is a header followed by
+ *  a ring of fixed-size records; once more than `capacity` records have
+ *  been written only the newest `capacity` are kept.
+ ****/
+#define TRACE_MAGIC 0x53435254u /* "TRCS" */
+#define TRACE_VERSION 1
+#define TRACE_DEFCAP (1u << 20) /* Default ring capacity in records */
+
+/** Trace file header **/
+typedef struct ScisSosTraceHeader
+{
+    uint32_t magic;       /* TRACE_MAGIC */
+    uint32_t version;     /* TRACE_VERSION */
+    uint32_t record_size; /* sizeof(ScisSosTraceRecord) */
+    uint32_t capacity;    /* Records in the ring (power of two) */
+    uint64_t written;     /* Records written in total */
+    uint64_t reserved;    /* Keeps records 8-byte aligned */
+} ScisSosTraceHeader;
+
+/** One state transition **/
+typedef struct ScisSosTraceRecord
+{
+    uint64_t time;     /* Simulated clock at the transition */
+    int32_t pid;       /* Process ID */
+    int32_t pc;        /* Program counter at the transition */
+    uint8_t old_state; /* PS_* state before */
+    uint8_t new_state; /* PS_* state after */
+    uint8_t pad[6];    /* Unused, zero */
+} ScisSosTraceRecord;
+
+/** Trace functions found in trace.c file; the decoder needs only the layout above **/
+#ifdef SCISSOS_H
+int scissos_trace_open(ScisSosContext *ctx, const char *path, uint32_t capacity); /* Start tracing; NULL path keeps it in memory */
+void scissos_trace_close(ScisSosContext *ctx);                              /* Stop tracing and flush the file */
+void scissos_trace_record(ScisSosContext *ctx, int pid, int old_state, int new_state, int pc); /* Append a record */
+int scissos_trace_enabled(ScisSosContext *ctx);                             /* True while a trace is open */
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trace.h"
+
+static const char *state_names[] = {"NEW", "READY", "RUNNING", "BLOCKED",
+                                    "SUSP_READY", "SUSP_BLOCKED", "DEAD"};
+
+// Name of a state, "?" if out of range
+static const char *state_name(int state)
+{
+    return state < (int)(sizeof(state_names) / sizeof(state_names[0])) ? state_names[state] : "?";
+}
+
+int main(int argc, char *argv[])
+{
+    int csv = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c")) != -1)
+    {
+        if (opt == 'c')
+        {
+            csv = 1;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [-c] <trace_file>\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (argc - optind != 1)
+    {
+        fprintf(stderr, "Usage: %s [-c] <trace_file>\n", argv[0]);
+        return 1;
+    }
+
+    int fd = open(argv[optind], O_RDONLY);
+    if (fd == -1)
+    {
+        perror("open trace file failed");
+        return 1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ScisSosTraceHeader))
+    {
+        fprintf(stderr, "Error: '%s' is not a trace file.\n", argv[optind]);
+        close(fd);
+        return 1;
+    }
+
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        perror("mmap trace file failed");
+        return 1;
+    }
+
+    const ScisSosTraceHeader *hdr = (const ScisSosTraceHeader *)map;
+    if (hdr->magic != TRACE_MAGIC || hdr->version != TRACE_VERSION ||
+        hdr->record_size != sizeof(ScisSosTraceRecord) ||
+        (size_t)st.st_size < sizeof(*hdr) + (size_t)hdr->capacity * sizeof(ScisSosTraceRecord))
+    {
+        fprintf(stderr, "Error: '%s' is not a version %d trace file.\n", argv[optind], TRACE_VERSION);
+        munmap(map, st.st_size);
+        return 1;
+    }
+
+    const ScisSosTraceRecord *ring = (const ScisSosTraceRecord *)(hdr + 1);
+
+    // Only the newest `capacity` records survive once the ring has wrapped
+    uint64_t count = hdr->written < hdr->capacity ? hdr->written : hdr->capacity;
+    uint64_t first = hdr->written - count;
+
+    if (csv)
+    {
+        fprintf(stdout, "seq,time,pid,pc,old_state,new_state\n");
+    }
+    else if (first > 0)
+    {
+        fprintf(stdout, "# ring wrapped: %llu oldest records were overwritten\n",
+                (unsigned long long)first);
+    }
+
+    for (uint64_t seq = first; seq < hdr->written; seq++)
+    {
+        const ScisSosTraceRecord *rec = &ring[seq & (hdr->capacity - 1)];
+
+        if (csv)
+        {
+            fprintf(stdout, "%llu,%llu,%d,%d,%s,%s\n", (unsigned long long)seq,
+                    (unsigned long long)rec->time, rec->pid, rec->pc,
+                    state_name(rec->old_state), state_name(rec->new_state));
+        }
+        else
+        {
+            fprintf(stdout, "[%llu] t=%llu PID %d PC=%d %s -> %s\n", (unsigned long long)seq,
+                    (unsigned long long)rec->time, rec->pid, rec->pc,
+                    state_name(rec->old_state), state_name(rec->new_state));
+        }
+    }
+
+    munmap(map, st.st_size);
+    return 0;
+}
@@ -0,0 +1,515 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ScisSos.h"
+#include "workload.h"
+
+#define BULK_BATCH 256 /* Processes a worker claims at a time */
+
+/** One process of a bulk workload; drawn serially, built by the workers **/
+typedef struct
+{
+    int pid;
+    int size;
+    int priority;
+    int p_type;
+    ScisSosCode *code;
+    ScisSosPCB *pcb; /* NULL until built, or if allocation failed */
+} ScisSosBulkProc;
+
+/** Work shared by the builder threads **/
+typedef struct
+{
+    ScisSosContext *ctx;
+    ScisSosBulkProc *procs;
+    int count;
+    int next; /* First unclaimed process, advanced atomically */
+} ScisSosBulkWork;
+
+// Parse a process mix "R/C/I" into relative weights of PT_REG, PT_CMP and PT_IOE
+int scissos_parse_mix(const char *spec, int type_weight[3])
+{
+    int total = 0;
+    const char *p = spec;
+
+    for (int t = PT_REG; t <= PT_IOE; t++)
+    {
+        char *end;
+        long w = strtol(p, &end, 10);
+
+        if (end == p || w < 0 || w > 1000000 || (t < PT_IOE && *end != '/') || (t == PT_IOE && *end != '\0'))
+        {
+            fprintf(stderr, "Error: Invalid process mix '%s' (use R/C/I, e.g. 1/1/1)\n", spec);
+            return -1;
+        }
+
+        type_weight[t] = (int)w;
+        total += (int)w;
+        p = end + 1;
+    }
+
+    if (total == 0)
+    {
+        fprintf(stderr, "Error: Process mix '%s' has no processes\n", spec);
+        return -1;
+    }
+    return 0;
+}
+
+// Parse a real-time load "tasks:util": that many periodic processes sharing the utilisation
+int scissos_parse_rt(const char *spec, int *tasks, double *util)
+{
+    char *end;
+    long n = strtol(spec, &end, 10);
+
+    if (end == spec || *end != ':' || n < 0 || n > PID_SLOT_MASK)
+    {
+        fprintf(stderr, "Error: Invalid real-time load '%s' (use tasks:util, e.g. 5:0.6)\n", spec);
+        return -1;
+    }
+
+    const char *u = end + 1;
+    double value = strtod(u, &end);
+    if (end == u || *end != '\0' || value < 0 || value > 1)
+    {
+        fprintf(stderr, "Error: Real-time utilisation in '%s' must be between 0 and 1\n", spec);
+        return -1;
+    }
+
+    *tasks = (int)n;
+    *util = value;
+    return 0;
+}
+
+// Build one process exactly as scissos_proc_create would: UID and code from its own stream
+static void scissos_bulk_build(ScisSosContext *ctx, ScisSosBulkProc *bp)
+{
+    ScisSosRng rng;
+    scissos_rng_seed(&rng, ctx->seed, (unsigned long long)bp->pid);
+
+    int uid = scissos_rng_below(&rng, MAXUSRS) + 1;
+    scissos_code_fill(bp->code, &rng, bp->p_type);
+
+    bp->pcb = (ScisSosPCB *)malloc(sizeof(ScisSosPCB));
+    if (bp->pcb)
+    {
+        scissos_pcb_init(ctx, bp->pcb, bp->pid, uid, bp->size, bp->priority, bp->p_type, bp->code);
+    }
+}
+
+// Builder thread: claim batches of processes until none are left
+static void *scissos_bulk_worker(void *arg)
+{
+    ScisSosBulkWork *work = (ScisSosBulkWork *)arg;
+
+    for (;;)
+    {
+        int start = __atomic_fetch_add(&work->next, BULK_BATCH, __ATOMIC_RELAXED);
+        if (start >= work->count)
+        {
+            return NULL;
+        }
+
+        int end = start + BULK_BATCH < work->count ? start + BULK_BATCH : work->count;
+        for (int i = start; i < end; i++)
+        {
+            scissos_bulk_build(work->ctx, &work->procs[i]);
+        }
+    }
+}
+
+// Make the first rt_tasks processes periodic with implicit deadlines. Their utilisations are
+// an unbiased random split of rt_util (UUniFast) and periods are log-uniform between
+// RT_MIN_PERIOD and RT_MAX_PERIOD.
+static void scissos_workload_rt(ScisSosContext *ctx, const ScisSosBulkProc *procs, const ScisSosWorkloadSpec *spec)
+{
+    double left = spec->rt_util;
+
+    for (int i = 0; i < spec->rt_tasks; i++)
+    {
+        int remaining = spec->rt_tasks - i;
+        double next = remaining > 1 ? left * pow(scissos_rng_double(&ctx->rng), 1.0 / (remaining - 1)) : 0.0;
+        double util = left - next;
+        left = next;
+
+        int period = (int)(RT_MIN_PERIOD * pow((double)RT_MAX_PERIOD / RT_MIN_PERIOD, scissos_rng_double(&ctx->rng)));
+        int wcet = (int)(util * period);
+        scissos_proc_set_realtime(ctx, procs[i].pid, period, period, wcet > 0 ? wcet : 1);
+    }
+}
+
+// Create a synthetic workload. Attributes, PIDs and code blocks are drawn serially from the
+// context; PCBs and instruction streams are then built on spec->threads threads and finally
+// registered in PID order, so the result does not depend on the thread count.
+int scissos_workload_create(ScisSosContext *ctx, const ScisSosWorkloadSpec *spec)
+{
+    int total = spec->type_weight[PT_REG] + spec->type_weight[PT_CMP] + spec->type_weight[PT_IOE];
+
+    // Sizes reach 1.5 * mean_size and must stay within int
+    if (spec->count < 0 || spec->mean_size < 1 || spec->mean_size > INT_MAX / 3 * 2 ||
+        spec->max_priority < 1 || total <= 0 || spec->rt_tasks < 0 || spec->rt_tasks > spec->count ||
+        spec->rt_util < 0 || spec->rt_util > 1)
+    {
+        fprintf(stderr, "Error: Invalid workload specification.\n");
+        return -1;
+    }
+
+    ScisSosBulkProc *procs = (ScisSosBulkProc *)calloc(spec->count ? spec->count : 1, sizeof(ScisSosBulkProc));
+    if (!procs)
+    {
+        fprintf(stderr, "Error: Memory allocation failed for workload.\n");
+        return -1;
+    }
+
+    int reserved = 0;
+    for (; reserved < spec->count; reserved++)
+    {
+        ScisSosBulkProc *bp = &procs[reserved];
+
+        bp->size = spec->mean_size / 2 + scissos_rng_below(&ctx->rng, spec->mean_size + 1);
+        bp->priority = scissos_rng_below(&ctx->rng, spec->max_priority) + 1;
+
+        // Pick the type in proportion to its weight
+        int r = scissos_rng_below(&ctx->rng, total);
+        bp->p_type = PT_REG;
+        while (r >= spec->type_weight[bp->p_type])
+        {
+            r -= spec->type_weight[bp->p_type++];
+        }
+
+        bp->pid = scissos_pid_alloc(ctx);
+        if (bp->pid == EMPTY)
+        {
+            fprintf(stderr, "Error: Process table full. Cannot create more processes.\n");
+            break;
+        }
+        bp->code = scissos_code_alloc(ctx, bp->size);
+        if (!bp->code)
+        {
+            scissos_pid_release(ctx, bp->pid);
+            break;
+        }
+    }
+
+    // Build PCBs and code in parallel; fall back to this thread if workers cannot start
+    ScisSosBulkWork work = {ctx, procs, reserved, 0};
+    int nthreads = spec->threads > 1 ? spec->threads : 1;
+    pthread_t *threads = (pthread_t *)calloc(nthreads, sizeof(pthread_t));
+    int started = 0;
+
+    while (threads && started < nthreads - 1 &&
+           pthread_create(&threads[started], NULL, scissos_bulk_worker, &work) == 0)
+    {
+        started++;
+    }
+    scissos_bulk_worker(&work);
+    for (int t = 0; t < started; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+
+    // Register in PID order; undo everything if any part of the workload is missing
+    int failed = reserved < spec->count;
+    for (int i = 0; i < reserved && !failed; i++)
+    {
+        failed = procs[i].pcb == NULL;
+    }
+
+    for (int i = 0; i < reserved; i++)
+    {
+        ScisSosBulkProc *bp = &procs[i];
+
+        if (failed)
+        {
+            free(bp->pcb);
+            scissos_arena_release(ctx, bp->code);
+            scissos_pid_release(ctx, bp->pid);
+            continue;
+        }
+
+        if (scissos_proc_register(ctx, bp->pcb) != 0)
+        {
+            // the policy could not queue it: take it and every process before it back out
+            for (int j = 0; j <= i; j++)
+            {
+                scissos_proc_delete(ctx, procs[j].pid);
+            }
+            failed = 1;
+            continue;
+        }
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "Process created: workload, PID: %d, UID: %d, Priority: %d, Type: %d\n",
+                    bp->pid, bp->pcb->uid, bp->priority, bp->p_type);
+    }
+
+    if (!failed)
+    {
+        scissos_workload_rt(ctx, procs, spec);
+    }
+
+    free(procs);
+    if (failed)
+    {
+        fprintf(stderr, "Error: Failed to create workload of %d processes.\n", spec->count);
+        return -1;
+    }
+    return spec->count;
+}
+
+// Bytes of a packed code block in a workload file, padded to 8
+static uint64_t scissos_code_bytes(int size)
+{
+    uint64_t words = CODE_WORDS(size);
+    uint64_t bytes = words * sizeof(unsigned long long) + (words + 1) * sizeof(int) +
+                     (uint64_t)size * sizeof(unsigned short);
+    return (bytes + 7) & ~(uint64_t)7;
+}
+
+// Write every process in the table, in PID order, to a workload file
+int scissos_workload_save(ScisSosContext *ctx, const char *path)
+{
+    static const char zero[8] = {0};
+    ScisSosWorkloadHeader hdr = {WORKLOAD_MAGIC, WORKLOAD_VERSION, sizeof(ScisSosWorkloadRecord), 0, ctx->seed, 0};
+
+    for (int i = 0; i < ctx->slot_high; i++)
+    {
+        if (ctx->proctable[i] != NULL && ctx->proctable[i]->p_code->lazy)
+        {
+            fprintf(stderr, "Error: Lazily generated code cannot be saved to a workload file.\n");
+            return -1;
+        }
+        hdr.count += ctx->proctable[i] != NULL;
+    }
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Error: Cannot open workload file '%s'.\n", path);
+        return -1;
+    }
+
+    // Records first, so the code offsets are known before any code is written
+    uint64_t records_end = sizeof(hdr) + (uint64_t)hdr.count * sizeof(ScisSosWorkloadRecord);
+    uint64_t offset = (records_end + 7) & ~(uint64_t)7;
+    hdr.file_size = offset;
+    for (int i = 0; i < ctx->slot_high; i++)
+    {
+        if (ctx->proctable[i] != NULL)
+        {
+            hdr.file_size += scissos_code_bytes(ctx->proctable[i]->size);
+        }
+    }
+    fwrite(&hdr, sizeof(hdr), 1, out);
+
+    for (int i = 0; i < ctx->slot_high; i++)
+    {
+        const ScisSosPCB *pcb = ctx->proctable[i];
+        if (pcb != NULL)
+        {
+            ScisSosWorkloadRecord rec = {pcb->size, pcb->priority_value, pcb->p_type, pcb->uid, offset,
+                                         pcb->period, pcb->rel_deadline, pcb->wcet, 0};
+            fwrite(&rec, sizeof(rec), 1, out);
+            offset += scissos_code_bytes(pcb->size);
+        }
+    }
+    fwrite(zero, 1, (size_t)(((records_end + 7) & ~(uint64_t)7) - records_end), out);
+
+    for (int i = 0; i < ctx->slot_high; i++)
+    {
+        const ScisSosPCB *pcb = ctx->proctable[i];
+        if (pcb == NULL)
+        {
+            continue;
+        }
+
+        const ScisSosCode *code = pcb->p_code;
+        int words = CODE_WORDS(code->size);
+        size_t used = (size_t)words * sizeof(unsigned long long) + (size_t)(words + 1) * sizeof(int) +
+                      (size_t)code->size * sizeof(unsigned short);
+
+        fwrite(code->lng, sizeof(unsigned long long), words, out);
+        fwrite(code->skip, sizeof(int), words + 1, out);
+        fwrite(code->addref, sizeof(unsigned short), code->size, out);
+        fwrite(zero, 1, scissos_code_bytes(code->size) - used, out);
+    }
+
+    if (ferror(out) | fclose(out))
+    {
+        fprintf(stderr, "Error: Cannot write workload file '%s'.\n", path);
+        return -1;
+    }
+    return (int)hdr.count;
+}
+
+// Check a stored code block's skip index against its bitmap, as scissos_code_index builds it:
+// every skip[w] lies in [w*64, size], never decreases and skip[words] is size, so no pc
+// taken from it can leave the code
+static int scissos_code_valid(const char *block, int size)
+{
+    int words = CODE_WORDS(size);
+    const unsigned long long *lng = (const unsigned long long *)block;
+    const int *skip = (const int *)(lng + words);
+
+    // no long syscall past the end of the code in the last word
+    if (size % 64 != 0 && lng[words - 1] >> (size % 64) != 0)
+    {
+        return 0;
+    }
+
+    if (skip[words] != size)
+    {
+        return 0;
+    }
+    for (int w = words - 1; w >= 0; w--)
+    {
+        int expect = lng[w] ? w * 64 + __builtin_ctzll(lng[w]) : skip[w + 1];
+        if (skip[w] != expect || skip[w] < w * 64 || skip[w] > skip[w + 1])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Delete every process whose code lives in the mapped workload, then unmap it
+static void scissos_workload_unload(ScisSosContext *ctx)
+{
+    const char *start = (const char *)ctx->workload_map;
+
+    for (int slot = 0; slot < ctx->slot_high; slot++)
+    {
+        ScisSosPCB *pcb = ctx->proctable[slot];
+        if (pcb != NULL && pcb->p_code != NULL && (const char *)pcb->p_code->lng >= start &&
+            (const char *)pcb->p_code->lng < start + ctx->workload_bytes)
+        {
+            scissos_proc_delete(ctx, pcb->pid);
+        }
+    }
+    scissos_workload_unmap(ctx);
+}
+
+// Map a workload file and create its processes; their code is used in place, without copying
+int scissos_workload_load(ScisSosContext *ctx, const char *path)
+{
+    if (ctx->workload_map != NULL)
+    {
+        fprintf(stderr, "Error: A workload file is already loaded.\n");
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+    {
+        fprintf(stderr, "Error: Cannot open workload file '%s'.\n", path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ScisSosWorkloadHeader))
+    {
+        fprintf(stderr, "Error: '%s' is not a workload file.\n", path);
+        close(fd);
+        return -1;
+    }
+
+    size_t bytes = (size_t)st.st_size;
+    void *map = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "Error: Memory mapping failed for workload file '%s'.\n", path);
+        return -1;
+    }
+
+    const ScisSosWorkloadHeader *hdr = (const ScisSosWorkloadHeader *)map;
+    const ScisSosWorkloadRecord *recs = (const ScisSosWorkloadRecord *)(hdr + 1);
+    int valid = hdr->magic == WORKLOAD_MAGIC && hdr->version == WORKLOAD_VERSION &&
+                hdr->record_size == sizeof(ScisSosWorkloadRecord) && hdr->file_size == bytes &&
+                sizeof(*hdr) + (uint64_t)hdr->count * sizeof(ScisSosWorkloadRecord) <= bytes;
+
+    // Check every record up front so a bad file creates nothing
+    for (uint32_t i = 0; valid && i < hdr->count; i++)
+    {
+        const ScisSosWorkloadRecord *r = &recs[i];
+        valid = r->size > 0 && r->p_type >= PT_REG && r->p_type <= PT_IOE && r->uid >= 1 &&
+                r->uid <= MAXUSRS && (r->code & 7) == 0 &&
+                (r->period == 0 || (r->wcet > 0 && r->wcet <= r->deadline && r->deadline <= r->period)) &&
+                r->code <= bytes && scissos_code_bytes(r->size) <= bytes - r->code &&
+                scissos_code_valid((const char *)map + r->code, r->size);
+    }
+
+    if (!valid)
+    {
+        fprintf(stderr, "Error: '%s' is not a valid version %d workload file.\n", path, WORKLOAD_VERSION);
+        munmap(map, bytes);
+        return -1;
+    }
+
+    ctx->workload_map = map;
+    ctx->workload_bytes = bytes;
+    madvise(map, bytes, MADV_WILLNEED);
+
+    for (uint32_t i = 0; i < hdr->count; i++)
+    {
+        const ScisSosWorkloadRecord *r = &recs[i];
+        char *block = (char *)map + r->code;
+        int words = CODE_WORDS(r->size);
+
+        int pid = scissos_pid_alloc(ctx);
+        ScisSosCode *code = pid != EMPTY ? (ScisSosCode *)scissos_arena_alloc(ctx, sizeof(ScisSosCode)) : NULL;
+        ScisSosPCB *pcb = code != NULL ? (ScisSosPCB *)malloc(sizeof(ScisSosPCB)) : NULL;
+        if (pcb == NULL)
+        {
+            fprintf(stderr, "Error: Cannot create process %u of workload '%s'.\n", i, path);
+            scissos_arena_release(ctx, code);
+            if (pid != EMPTY)
+            {
+                scissos_pid_release(ctx, pid);
+            }
+            scissos_workload_unload(ctx);
+            return -1;
+        }
+
+        // Only the small header is allocated; the arrays stay in the mapping
+        code->size = r->size;
+        code->base = 0;
+        code->limit = r->size;
+        code->lazy = 0;
+        code->lng = (unsigned long long *)block;
+        code->skip = (int *)(code->lng + words);
+        code->addref = (unsigned short *)(code->skip + words + 1);
+
+        scissos_pcb_init(ctx, pcb, pid, r->uid, r->size, r->priority, r->p_type, code);
+        if (scissos_proc_register(ctx, pcb) != 0)
+        {
+            scissos_proc_delete(ctx, pid);
+            scissos_workload_unload(ctx);
+            return -1;
+        }
+        SCISSOS_LOG(ctx, LOG_DECISIONS, "Process loaded: PID: %d, UID: %d, Size: %d, Priority: %d, Type: %d\n",
+                    pid, r->uid, r->size, r->priority, r->p_type);
+
+        // a real-time process that is not admitted runs as best effort
+        if (r->period > 0)
+        {
+            scissos_proc_set_realtime(ctx, pid, r->period, r->deadline, r->wcet);
+        }
+    }
+
+    return (int)hdr->count;
+}
+
+// Unmap the workload file; only call once the processes using it are deleted
+void scissos_workload_unmap(ScisSosContext *ctx)
+{
+    if (ctx->workload_map != NULL)
+    {
+        munmap(ctx->workload_map, ctx->workload_bytes);
+        ctx->workload_map = NULL;
+        ctx->workload_bytes = 0;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+
+/****
+ *  Binary workload file. A header, one fixed-size record per process and
+ *  then each process's packed code exactly as ScisSosCode lays it out in
+ *  memory (long-syscall bitmap, skip index, addresses), so a mapped file
+ *  is used in place. Fields are in host byte order.
+ ****/
+#define WORKLOAD_MAGIC 0x444C4B57u /* "WKLD" */
+#define WORKLOAD_VERSION 2
+
+/** Workload file header **/
+typedef struct
+{
+    uint32_t magic;       /* WORKLOAD_MAGIC */
+    uint32_t version;     /* WORKLOAD_VERSION */
+    uint32_t record_size; /* sizeof(ScisSosWorkloadRecord) */
+    uint32_t count;       /* Process records following the header */
+    uint64_t seed;        /* Master seed the workload was generated with */
+    uint64_t file_size;   /* Bytes in the whole file */
+} ScisSosWorkloadHeader;
+
+/** One process; its code block starts at byte `code` of the file **/
+typedef struct
+{
+    int32_t size;     /* Instructions */
+    int32_t priority; /* Priority value */
+    int32_t p_type;   /* PT_* process type */
+    int32_t uid;      /* User ID */
+    uint64_t code;    /* File offset of the code block, 8-byte aligned */
+    int32_t period;   /* Real-time release period, 0 if best effort */
+    int32_t deadline; /* Real-time deadline relative to each release */
+    int32_t wcet;     /* Real-time instructions per job */
+    int32_t reserved; /* Zero */
+} ScisSosWorkloadRecord;
+
+/** Workload file functions found in workload.c file **/
+#ifdef SCISSOS_H
+int scissos_workload_save(ScisSosContext *ctx, const char *path); /* Write every process in the table */
+int scissos_workload_load(ScisSosContext *ctx, const char *path); /* Map a file and create its processes */
+void scissos_workload_unmap(ScisSosContext *ctx);                 /* Drop the mapping once processes are gone */
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ScisSos.h"
+#include "workload.h"
+
+#define DEF_COUNT 1000 /* Default number of processes */
+#define DEF_PSIZE 5000 /* Default mean instructions per process */
+
+// Print command line usage
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-n processes] [-z instructions] [-x R/C/I] [-P max_priority] [-s seed] [-j threads] [-R tasks:util] <workload_file>\n",
+            prog);
+    fprintf(stderr, "  defaults: -n %d -z %d -x 1/1/1 -P %d -s <time> -j 1 -R 0:0\n", DEF_COUNT, DEF_PSIZE, 2 * DEFPRIO);
+}
+
+int main(int argc, char *argv[])
+{
+    ScisSosWorkloadSpec spec = {DEF_COUNT, DEF_PSIZE, {1, 1, 1}, 2 * DEFPRIO, 1, 0, 0.0};
+    unsigned long long seed = (unsigned long long)time(NULL);
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:z:x:P:s:j:R:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            spec.count = atoi(optarg);
+            break;
+        case 'z':
+            spec.mean_size = atoi(optarg);
+            break;
+        case 'x':
+            if (scissos_parse_mix(optarg, spec.type_weight) != 0)
+            {
+                return 1;
+            }
+            break;
+        case 'P':
+            spec.max_priority = atoi(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'j':
+            spec.threads = atoi(optarg);
+            break;
+        case 'R':
+            if (scissos_parse_rt(optarg, &spec.rt_tasks, &spec.rt_util) != 0)
+            {
+                return 1;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (argc - optind != 1 || spec.count < 1 || spec.count > PID_SLOT_MASK)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ScisSosContext *ctx = scissos_context_create();
+    if (ctx == NULL)
+    {
+        return 1;
+    }
+    scissos_set_log_level(ctx, LOG_OFF);
+    scissos_initialise(ctx);
+    scissos_seed(ctx, seed);
+
+    int status = 1;
+    if (scissos_workload_create(ctx, &spec) >= 0 && scissos_workload_save(ctx, argv[optind]) >= 0)
+    {
+        fprintf(stdout, "Wrote %d processes (seed %llu) to %s\n", spec.count, seed, argv[optind]);
+        status = 0;
+    }
+
+    scissos_context_destroy(ctx);
+    return status;
+}